@@ -0,0 +1,159 @@
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+namespace
+{
+std::atomic<uint64_t> g_allocations{0};
+
+void * countedAllocate(std::size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void * ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void * countedAllocate(std::size_t size, std::align_val_t alignment)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  // posix_memalign needs at least the alignment of a pointer, std::free releases it
+  const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void *));
+  void * ptr = nullptr;
+  if (posix_memalign(&ptr, align, size == 0 ? 1 : size) == 0) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+}  // namespace
+
+namespace ros2_gremsy
+{
+uint64_t allocationCount()
+{
+  return g_allocations.load(std::memory_order_relaxed);
+}
+}  // namespace ros2_gremsy
+
+// Replacing the global operators counts every allocation of the process, including rclcpp and the middleware
+void * operator new(std::size_t size)
+{
+  return countedAllocate(size);
+}
+
+void * operator new[](std::size_t size)
+{
+  return countedAllocate(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  try {
+    return countedAllocate(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  try {
+    return countedAllocate(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+  return countedAllocate(size, alignment);
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return countedAllocate(size, alignment);
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  try {
+    return countedAllocate(size, alignment);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+  try {
+    return countedAllocate(size, alignment);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void operator delete(void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
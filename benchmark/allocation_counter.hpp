@@ -0,0 +1,27 @@
+#ifndef ROS2_GREMSY__BENCHMARK__ALLOCATION_COUNTER_HPP_
+#define ROS2_GREMSY__BENCHMARK__ALLOCATION_COUNTER_HPP_
+
+#include <cstdint>
+
+namespace ros2_gremsy
+{
+
+/// Number of heap allocations through operator new in the benchmark process so far
+uint64_t allocationCount();
+
+/// Counts the allocations between its construction and allocations()
+class AllocationScope
+{
+public:
+  AllocationScope()
+  : start_(allocationCount()) {}
+
+  uint64_t allocations() const {return allocationCount() - start_;}
+
+private:
+  uint64_t start_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__BENCHMARK__ALLOCATION_COUNTER_HPP_
@@ -0,0 +1,18 @@
+#include <benchmark/benchmark.h>
+
+#include <rclcpp/rclcpp.hpp>
+
+// The publish cycle benchmarks need a ROS context, the others run without one.
+// Use --benchmark_out=<file> --benchmark_out_format=json for machine-readable results.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    rclcpp::shutdown();
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
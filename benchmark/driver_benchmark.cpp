@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <optional>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "ros2_gremsy/command_scheduler.hpp"
+#include "ros2_gremsy/device_traits.hpp"
+#include "ros2_gremsy/gimbal_state_publisher.hpp"
+#include "ros2_gremsy/setpoint_filter.hpp"
+#include "ros2_gremsy/setpoint_shaper.hpp"
+
+#include "allocation_counter.hpp"
+#include "fake_gimbal.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+constexpr double kPollPeriod = 1.0 / 300.0;
+/// Cycles run before counting allocations, so that one-time initialization is excluded
+constexpr int kWarmupCycles = 1000;
+
+GimbalStatePublisher::Config publisherConfig(
+  bool attitude_filter, bool use_ros_time, bool legacy_topics = true)
+{
+  GimbalStatePublisher::Config config;
+  config.imu.accel_scale = NOMINAL_ACCEL_SCALE;
+  config.imu.gyro_scale = NOMINAL_GYRO_SCALE;
+  config.imu.accel_stddev = 0.05;
+  config.imu.gyro_stddev = 0.005;
+  config.attitude_filter = attitude_filter;
+  config.use_ros_time = use_ros_time;
+  config.legacy_topics = legacy_topics;
+  return config;
+}
+
+geometry_msgs::msg::Vector3 goalAt(std::size_t i)
+{
+  geometry_msgs::msg::Vector3 goal;
+  goal.x = 0.1 * std::sin(0.01 * i);
+  goal.y = -0.5 + 0.3 * std::cos(0.01 * i);
+  goal.z = 3.0 * std::sin(0.003 * i);
+  return goal;
+}
+
+void BM_PrepareGimbalMove(benchmark::State & state)
+{
+  const PrepareGimbalMoveFunction prepare =
+    getPrepareGimbalMove(static_cast<gremsy_model_t>(state.range(0)));
+  const bool continuous_yaw = state.range(1) != 0;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::optional<double> current_pan =
+      continuous_yaw ? std::optional<double>(170.0) : std::nullopt;
+    benchmark::DoNotOptimize(prepare(goalAt(i++), false, 0.2, current_pan));
+  }
+  state.SetLabel(getDeviceProfile(static_cast<gremsy_model_t>(state.range(0))).name);
+}
+BENCHMARK(BM_PrepareGimbalMove)
+->ArgsProduct({benchmark::CreateDenseRange(0, NUM_OF_MODELS - 1, 1), {0, 1}});
+
+/**
+ * @brief Message conversion of one state timer cycle, without publishing
+ * test_allocations checks that it does not allocate in steady state, this part is fully
+ * under the control of the driver.
+ */
+void BM_StateUpdate(benchmark::State & state)
+{
+  auto node = std::make_shared<rclcpp::Node>("gremsy_benchmark");
+  GimbalStatePublisher publisher(*node, publisherConfig(state.range(0) != 0, true));
+  FakeGimbal gimbal;
+  for (int i = 0; i < kWarmupCycles; ++i) {
+    publisher.update(gimbal.poll(kPollPeriod));
+  }
+  AllocationScope allocations;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(publisher.update(gimbal.poll(kPollPeriod)));
+  }
+  state.counters["allocs_per_tick"] = benchmark::Counter(
+    static_cast<double>(allocations.allocations()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_StateUpdate)->ArgName("attitude_filter")->Arg(0)->Arg(1);
+
+/**
+ * @brief One state timer cycle, from the polled state to the published messages
+ * The allocations per tick include the ones of the middleware. Without the legacy
+ * topics, the cycle only publishes the combined ~/state message.
+ */
+void BM_StatePublishCycle(benchmark::State & state)
+{
+  auto node = std::make_shared<rclcpp::Node>("gremsy_benchmark");
+  GimbalStatePublisher publisher(
+    *node, publisherConfig(state.range(0) != 0, state.range(1) != 0, state.range(2) != 0));
+  FakeGimbal gimbal;
+  for (int i = 0; i < kWarmupCycles; ++i) {
+    publisher.publish(gimbal.poll(kPollPeriod));
+  }
+  AllocationScope allocations;
+  for (auto _ : state) {
+    publisher.publish(gimbal.poll(kPollPeriod));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["allocs_per_tick"] = benchmark::Counter(
+    static_cast<double>(allocations.allocations()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_StatePublishCycle)
+->ArgNames({"attitude_filter", "ros_time", "legacy"})
+->ArgsProduct({{0, 1}, {0, 1}, {0, 1}});
+
+/**
+ * @brief One goal timer cycle with a new goal, from the goal to the command scheduler
+ * Same steps as gimbalGoalTimerCallback, with the setpoint written to a counter
+ * instead of the serial port.
+ */
+void BM_GoalPath(benchmark::State & state)
+{
+  const bool shaping = state.range(0) != 0;
+  const PrepareGimbalMoveFunction prepare = getPrepareGimbalMove(GREMSY_T3V3);
+
+  std::atomic<uint64_t> written{0};
+  CommandScheduler scheduler(
+    CommandScheduler::Config(),
+    [&written](const Eigen::Vector3d &) {written.fetch_add(1, std::memory_order_relaxed);},
+    []() {return CommandScheduler::Ack();});
+  scheduler.start();
+
+  SetpointFilter filter;
+  SetpointFilter::Config filter_config;
+  filter_config.deadband = Eigen::Vector3d::Constant(0.05);
+  filter.configure(filter_config);
+
+  SetpointShaper shaper;
+  SetpointShaper::Limits limits;
+  limits.velocity = Eigen::Vector3d::Constant(90.0);
+  limits.acceleration = Eigen::Vector3d::Constant(180.0);
+  limits.jerk = Eigen::Vector3d::Constant(720.0);
+  shaper.setLimits(limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+
+  std::size_t i = 0;
+  AllocationScope allocations;
+  for (auto _ : state) {
+    Eigen::Vector3d setpoint = prepare(goalAt(i++), false, 0.2, 170.0);
+    if (shaping) {
+      shaper.setTarget(setpoint);
+      setpoint = shaper.step(kPollPeriod);
+    }
+    if (filter.accept(setpoint, SetpointFilter::Clock::now())) {
+      scheduler.submitSetpoint(setpoint);
+    }
+  }
+  const uint64_t allocated = allocations.allocations();
+  scheduler.stop();
+  state.counters["allocs_per_tick"] = benchmark::Counter(
+    static_cast<double>(allocated), benchmark::Counter::kAvgIterations);
+  state.counters["suppressed"] = static_cast<double>(filter.counters().suppressed);
+  state.counters["written"] = static_cast<double>(written.load());
+}
+BENCHMARK(BM_GoalPath)->ArgName("shaping")->Arg(0)->Arg(1);
+
+}  // namespace
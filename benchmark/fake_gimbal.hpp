@@ -0,0 +1,61 @@
+#ifndef ROS2_GREMSY__BENCHMARK__FAKE_GIMBAL_HPP_
+#define ROS2_GREMSY__BENCHMARK__FAKE_GIMBAL_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+#include "ros2_gremsy/gimbal_state.hpp"
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Stand-in for readGimbalState on a Gimbal_Interface
+ * Produces the state a gimbal slowly sweeping its axes would report, with the
+ * IMU and mount orientation arriving at their own rates. It bypasses gSDK and its
+ * locks, BM_StatePoll covers them.
+ */
+class FakeGimbal
+{
+public:
+  /// Advance by one poll period and return the state a poll would read
+  const GimbalState & poll(double period)
+  {
+    time_ += period;
+    const double t = time_;
+    const uint64_t time_usec = static_cast<uint64_t>(t * 1e6);
+
+    // Raw IMU at 200 Hz, counts of a +-8 g accelerometer and a +-2000 deg/s gyro
+    if (time_usec - state_.raw_imu.time_usec >= 5000) {
+      state_.raw_imu.time_usec = time_usec;
+      state_.raw_imu.xacc = static_cast<int16_t>(40.0 * std::sin(t));
+      state_.raw_imu.yacc = static_cast<int16_t>(40.0 * std::cos(t));
+      state_.raw_imu.zacc = 4096;
+      state_.raw_imu.xgyro = static_cast<int16_t>(2.0 * std::cos(t));
+      state_.raw_imu.ygyro = static_cast<int16_t>(2.0 * std::sin(t));
+      state_.raw_imu.zgyro = static_cast<int16_t>(16.4 * 10.0 * std::cos(0.2 * t));
+    }
+    // Mount status and orientation at 50 Hz
+    if (time_usec - state_.mount_status_time_usec >= 20000) {
+      state_.mount_status_time_usec = time_usec;
+      state_.mount_status.pointing_a = static_cast<int32_t>(10.0 * std::sin(t));
+      state_.mount_status.pointing_b = static_cast<int32_t>(5.0 * std::cos(t));
+      state_.mount_status.pointing_c = static_cast<int32_t>(50.0 * std::sin(0.2 * t));
+      state_.mount_orientation_time_usec = time_usec;
+      state_.mount_orientation.time_boot_ms = static_cast<uint32_t>(time_usec / 1000);
+      state_.mount_orientation.roll = static_cast<float>(5.0 * std::cos(t));
+      state_.mount_orientation.pitch = static_cast<float>(10.0 * std::sin(t));
+      state_.mount_orientation.yaw = static_cast<float>(50.0 * std::sin(0.2 * t));
+      state_.mount_orientation.yaw_absolute = state_.mount_orientation.yaw + 30.0f;
+    }
+    return state_;
+  }
+
+private:
+  double time_ = 0.0;
+  GimbalState state_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__BENCHMARK__FAKE_GIMBAL_HPP_
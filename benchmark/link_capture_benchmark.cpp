@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "ros2_gremsy/link_capture.hpp"
+#include "ros2_gremsy/link_tap.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+LinkCapture::Config captureConfig()
+{
+  LinkCapture::Config config;
+  config.directory = "/tmp/ros2_gremsy_benchmark_capture";
+  config.max_files = 2;
+  return config;
+}
+
+/// Chunk of the link, the size of a typical MAVLink frame by default
+std::vector<uint8_t> chunk(std::size_t size)
+{
+  std::vector<uint8_t> data(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  return data;
+}
+
+/// Cost of capturing a chunk on the link thread, against copying it
+void BM_CaptureRecord_Memcpy(benchmark::State & state)
+{
+  const std::vector<uint8_t> data = chunk(static_cast<std::size_t>(state.range(0)));
+  std::vector<uint8_t> copy(data.size());
+  for (auto _ : state) {
+    std::memcpy(copy.data(), data.data(), data.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CaptureRecord_Memcpy)->Arg(40)->Arg(280)->Arg(4096);
+
+void BM_CaptureRecord(benchmark::State & state)
+{
+  const std::vector<uint8_t> data = chunk(static_cast<std::size_t>(state.range(0)));
+  LinkCapture capture(captureConfig());
+  for (auto _ : state) {
+    capture.record(LinkDirection::RX, data.data(), data.size());
+  }
+  // Far above any serial rate, so that this is the throughput of the writer thread
+  const LinkCapture::Stats stats = capture.stats();
+  state.counters["dropped_ratio"] =
+    static_cast<double>(stats.dropped_records) / static_cast<double>(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CaptureRecord)->Arg(40)->Arg(280)->Arg(4096);
+
+/**
+ * Round trip of a chunk from gSDK to the device through the tap, with and without
+ * the capture. Socket pairs stand in for the pseudo terminal and the serial device.
+ */
+void BM_LinkTapForward(benchmark::State & state)
+{
+  const bool capturing = state.range(0) != 0;
+  int device[2];
+  int sdk[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, device) != 0 ||
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sdk) != 0)
+  {
+    state.SkipWithError("Cannot create the socket pairs");
+    return;
+  }
+  std::unique_ptr<LinkCapture> capture;
+  if (capturing) {
+    capture = std::make_unique<LinkCapture>(captureConfig());
+  }
+  std::vector<uint8_t> data = chunk(40);
+  std::vector<uint8_t> received(data.size());
+  {
+    LinkTap tap(device[0], sdk[0], capture.get());
+    for (auto _ : state) {
+      if (write(sdk[1], data.data(), data.size()) != static_cast<ssize_t>(data.size())) {
+        state.SkipWithError("Write failed");
+        break;
+      }
+      std::size_t size = 0;
+      while (size < received.size()) {
+        const ssize_t n = read(device[1], received.data() + size, received.size() - size);
+        if (n <= 0) {
+          state.SkipWithError("Read failed");
+          break;
+        }
+        size += static_cast<std::size_t>(n);
+      }
+    }
+  }
+  close(device[1]);
+  close(sdk[1]);
+  state.SetLabel(capturing ? "capture" : "no capture");
+}
+BENCHMARK(BM_LinkTapForward)->Arg(0)->Arg(1)->UseRealTime();
+
+}  // namespace
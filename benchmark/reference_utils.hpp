@@ -0,0 +1,43 @@
+#ifndef ROS2_GREMSY__BENCHMARK__REFERENCE_UTILS_HPP_
+#define ROS2_GREMSY__BENCHMARK__REFERENCE_UTILS_HPP_
+
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "ros2_gremsy/utils.hpp"
+
+namespace ros2_gremsy
+{
+
+// Previous implementations of the utils.hpp converters, kept as the reference for the
+// equivalence tests and the benchmarks
+inline Eigen::Quaterniond referenceXYZtoQuaternion(double roll, double pitch, double yaw)
+{
+  return Eigen::Quaterniond(
+    Eigen::AngleAxisd(DEG_TO_RAD * roll, Eigen::Vector3d::UnitX()) *
+    Eigen::AngleAxisd(DEG_TO_RAD * pitch, Eigen::Vector3d::UnitY()) *
+    Eigen::AngleAxisd(-DEG_TO_RAD * yaw, Eigen::Vector3d::UnitZ()));
+}
+
+inline Eigen::Vector3d referenceQuaterniontoZYX(double x, double y, double z, double w)
+{
+  Eigen::Vector3d result;
+  double sinr_cosp = 2.0 * (w * x + y * z);
+  double cosr_cosp = 1.0 - 2.0 * (x * x + y * y);
+  result[0] = std::atan2(sinr_cosp, cosr_cosp);
+  double sinp = 2.0 * (w * y - z * x);
+  if (std::fabs(sinp) >= 1) {
+    result[1] = std::copysign(M_PI / 2, sinp);
+  } else {
+    result[1] = std::asin(sinp);
+  }
+  double siny_cosp = 2.0 * (w * z + x * y);
+  double cosy_cosp = 1.0 - 2.0 * (y * y + z * z);
+  result[2] = std::atan2(siny_cosp, cosy_cosp);
+  return result;
+}
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__BENCHMARK__REFERENCE_UTILS_HPP_
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "ros2_gremsy/device_traits.hpp"
+#include "ros2_gremsy/gimbal_state.hpp"
+#include "ros2_gremsy/gimbal_state_publisher.hpp"
+#include "ros2_gremsy/link_tap.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+/**
+ * @brief Gimbal on the master side of a pseudo terminal, for gSDK to talk to
+ * Sends heartbeats, and the raw IMU at 200 Hz and the mount status and orientation at
+ * 50 Hz as MAVLink frames, so that the real Gimbal_Interface receives, parses and stores
+ * them. What gSDK writes is read and discarded.
+ */
+class PtyGimbal
+{
+public:
+  PtyGimbal()
+  {
+    fd_ = LinkTap::openPseudoTerminal(slave_path_);
+    fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+    thread_ = std::thread([this]() {run();});
+  }
+
+  ~PtyGimbal()
+  {
+    running_ = false;
+    thread_.join();
+    close(fd_);
+  }
+
+  PtyGimbal(const PtyGimbal &) = delete;
+  PtyGimbal & operator=(const PtyGimbal &) = delete;
+
+  /// Path of the slave side, for gSDK to open as its serial port
+  const std::string & slavePath() const {return slave_path_;}
+
+private:
+  void send(const mavlink_message_t & message)
+  {
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t size = mavlink_msg_to_send_buffer(buffer, &message);
+    // A full pseudo terminal drops the frame, as a congested link would
+    if (write(fd_, buffer, size) < 0) {
+      return;
+    }
+  }
+
+  void run()
+  {
+    constexpr uint8_t kSystemId = 1;
+    constexpr uint8_t kComponentId = MAV_COMP_ID_GIMBAL;
+    const auto start = std::chrono::steady_clock::now();
+    mavlink_message_t message;
+    uint8_t discard[256];
+    for (uint64_t ms = 0; running_; ++ms) {
+      const uint64_t time_usec = 1000 * ms;
+      const double t = 1e-3 * static_cast<double>(ms);
+      if (ms % 1000 == 0) {
+        mavlink_heartbeat_t heartbeat{};
+        heartbeat.type = MAV_TYPE_GIMBAL;
+        heartbeat.autopilot = MAV_AUTOPILOT_INVALID;
+        mavlink_msg_heartbeat_encode(kSystemId, kComponentId, &message, &heartbeat);
+        send(message);
+      }
+      if (ms % 5 == 0) {
+        mavlink_raw_imu_t raw_imu{};
+        raw_imu.time_usec = time_usec;
+        raw_imu.xacc = static_cast<int16_t>(40.0 * std::sin(t));
+        raw_imu.yacc = static_cast<int16_t>(40.0 * std::cos(t));
+        raw_imu.zacc = 4096;
+        raw_imu.zgyro = static_cast<int16_t>(16.4 * 10.0 * std::cos(0.2 * t));
+        mavlink_msg_raw_imu_encode(kSystemId, kComponentId, &message, &raw_imu);
+        send(message);
+      }
+      if (ms % 20 == 0) {
+        mavlink_mount_status_t mount_status{};
+        mount_status.pointing_a = static_cast<int32_t>(10.0 * std::sin(t));
+        mount_status.pointing_b = static_cast<int32_t>(5.0 * std::cos(t));
+        mount_status.pointing_c = static_cast<int32_t>(50.0 * std::sin(0.2 * t));
+        mavlink_msg_mount_status_encode(kSystemId, kComponentId, &message, &mount_status);
+        send(message);
+
+        mavlink_mount_orientation_t mount_orientation{};
+        mount_orientation.time_boot_ms = static_cast<uint32_t>(ms);
+        mount_orientation.roll = static_cast<float>(5.0 * std::cos(t));
+        mount_orientation.pitch = static_cast<float>(10.0 * std::sin(t));
+        mount_orientation.yaw = static_cast<float>(50.0 * std::sin(0.2 * t));
+        mount_orientation.yaw_absolute = mount_orientation.yaw + 30.0f;
+        mavlink_msg_mount_orientation_encode(
+          kSystemId, kComponentId, &message, &mount_orientation);
+        send(message);
+      }
+      while (read(fd_, discard, sizeof(discard)) > 0) {
+      }
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(ms + 1));
+    }
+  }
+
+  int fd_ = -1;
+  std::string slave_path_;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+/**
+ * @brief One state timer cycle through gSDK, from its getters to the published messages
+ * Unlike the driver benchmarks, the state comes from a Gimbal_Interface receiving the
+ * streams of PtyGimbal, so the reads contend with the gSDK receive thread as on the
+ * gimbal. Each iteration is one poll, as fast as possible.
+ */
+void BM_StatePoll(benchmark::State & state)
+{
+  PtyGimbal gimbal;
+  Serial_Port serial_port(gimbal.slavePath().c_str(), 115200);
+  Gimbal_Interface gimbal_interface(&serial_port);
+  serial_port.start();
+  gimbal_interface.start();
+
+  auto node = std::make_shared<rclcpp::Node>("gremsy_benchmark");
+  GimbalStatePublisher::Config config;
+  config.imu.accel_scale = NOMINAL_ACCEL_SCALE;
+  config.imu.gyro_scale = NOMINAL_GYRO_SCALE;
+  GimbalStatePublisher publisher(*node, config);
+
+  uint64_t imu_samples = 0;
+  uint64_t last_imu_usec = 0;
+  for (auto _ : state) {
+    const GimbalState gimbal_state = readGimbalState(gimbal_interface);
+    publisher.publish(gimbal_state);
+    if (gimbal_state.raw_imu.time_usec != last_imu_usec) {
+      last_imu_usec = gimbal_state.raw_imu.time_usec;
+      ++imu_samples;
+    }
+  }
+  gimbal_interface.stop();
+  serial_port.stop();
+  state.counters["imu_samples"] = static_cast<double>(imu_samples);
+}
+BENCHMARK(BM_StatePoll)->UseRealTime()->MinTime(2.0);
+
+}  // namespace
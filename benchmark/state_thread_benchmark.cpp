@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <rclcpp/rclcpp.hpp>
+#include <std_msgs/msg/u_int64.hpp>
+
+#include "ros2_gremsy/periodic_thread.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+using Clock = PeriodicThread::Clock;
+
+/// Period of the state ticks at 300 Hz
+constexpr std::chrono::nanoseconds kStatePeriod(3333333);
+
+/**
+ * @brief Wakeup latency of the state timer, from its deadline to the start of its callback
+ * The timer is dispatched by the executor of the driver, optionally with a 1 kHz topic on
+ * the same node standing in for the goals. Each iteration is one tick, and the reported
+ * time is its latency.
+ */
+void BM_StateTimerLatency(benchmark::State & state)
+{
+  auto node = std::make_shared<rclcpp::Node>("gremsy_benchmark");
+  rclcpp::executors::MultiThreadedExecutor executor;
+  Clock::time_point woke;
+  uint64_t ticks = 0;
+  auto timer = node->create_wall_timer(
+    kStatePeriod, [&woke, &ticks]() {
+      woke = Clock::now();
+      ++ticks;
+    });
+
+  rclcpp::Publisher<std_msgs::msg::UInt64>::SharedPtr publisher;
+  rclcpp::Subscription<std_msgs::msg::UInt64>::SharedPtr subscription;
+  rclcpp::TimerBase::SharedPtr load_timer;
+  if (state.range(0) != 0) {
+    publisher = node->create_publisher<std_msgs::msg::UInt64>("~/load", 10);
+    subscription = node->create_subscription<std_msgs::msg::UInt64>(
+      "~/load", 10, [](std_msgs::msg::UInt64::ConstSharedPtr message) {
+        benchmark::DoNotOptimize(message->data);
+      });
+    load_timer = node->create_wall_timer(
+      std::chrono::milliseconds(1), [&publisher]() {
+        std_msgs::msg::UInt64 message;
+        publisher->publish(message);
+      });
+  }
+  executor.add_node(node);
+
+  for (auto _ : state) {
+    const Clock::time_point deadline = Clock::now() + timer->time_until_trigger();
+    // The executor may wake up for the load first
+    for (const uint64_t tick = ticks; ticks == tick; ) {
+      executor.spin_once();
+    }
+    state.SetIterationTime(std::chrono::duration<double>(woke - deadline).count());
+  }
+  state.SetLabel(state.range(0) != 0 ? "with 1 kHz topic" : "idle");
+}
+BENCHMARK(BM_StateTimerLatency)
+->ArgName("load")->Arg(0)->Arg(1)->UseManualTime()->Iterations(600);
+
+/**
+ * @brief Wakeup latency of the state publisher thread, from its deadline to its callback
+ * Same ticks as BM_StateTimerLatency, at the default scheduling or a real-time priority.
+ */
+void BM_StateThreadLatency(benchmark::State & state)
+{
+  std::mutex mutex;
+  std::condition_variable cv;
+  Clock::duration latency{};
+  uint64_t ticks = 0;
+
+  PeriodicThread::Config config;
+  config.priority = static_cast<int>(state.range(0));
+  PeriodicThread thread(
+    config, [&](Clock::time_point deadline) {
+      const Clock::duration tick_latency = Clock::now() - deadline;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        latency = tick_latency;
+        ++ticks;
+      }
+      cv.notify_one();
+    });
+  const bool scheduled = thread.start(kStatePeriod);
+
+  for (auto _ : state) {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint64_t tick = ticks;
+    cv.wait(lock, [&ticks, tick]() {return ticks != tick;});
+    state.SetIterationTime(std::chrono::duration<double>(latency).count());
+  }
+  thread.stop();
+  state.SetLabel(
+    config.priority == 0 ? "default scheduling" :
+    scheduled ? "SCHED_FIFO" : "SCHED_FIFO not permitted");
+}
+BENCHMARK(BM_StateThreadLatency)
+->ArgName("priority")->Arg(0)->Arg(80)->UseManualTime()->Iterations(600);
+
+}  // namespace
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "ros2_gremsy/utils.hpp"
+
+#include "reference_utils.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+constexpr std::size_t kSamples = 1024;
+
+/// Random angles in degrees, in the range of the gimbal orientations
+struct Angles
+{
+  std::vector<double> roll, pitch, yaw;
+
+  explicit Angles(std::size_t n)
+  : roll(n), pitch(n), yaw(n)
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-180.0, 180.0);
+    for (std::size_t i = 0; i < n; ++i) {
+      roll[i] = distribution(generator);
+      pitch[i] = distribution(generator) / 2.0;
+      yaw[i] = distribution(generator);
+    }
+  }
+};
+
+const Angles & angles()
+{
+  static const Angles samples(kSamples);
+  return samples;
+}
+
+void BM_XYZtoQuaternionMsg_Reference(benchmark::State & state)
+{
+  const Angles & a = angles();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    geometry_msgs::msg::Quaternion msg = tf2::toMsg(
+      referenceXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i]));
+    benchmark::DoNotOptimize(msg);
+    i = (i + 1) % kSamples;
+  }
+}
+BENCHMARK(BM_XYZtoQuaternionMsg_Reference);
+
+void BM_XYZtoQuaternionMsg_ClosedForm(benchmark::State & state)
+{
+  const Angles & a = angles();
+  geometry_msgs::msg::Quaternion msg;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    convertXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i], msg);
+    benchmark::DoNotOptimize(msg);
+    i = (i + 1) % kSamples;
+  }
+}
+BENCHMARK(BM_XYZtoQuaternionMsg_ClosedForm);
+
+void BM_XYZtoQuaternion_Batch(benchmark::State & state)
+{
+  const Angles & a = angles();
+  const std::size_t n = static_cast<std::size_t>(state.range(0));
+  std::vector<double> w(n), x(n), y(n), z(n);
+  for (auto _ : state) {
+    convertXYZtoQuaternion(
+      a.roll.data(), a.pitch.data(), a.yaw.data(), n, w.data(), x.data(), y.data(), z.data());
+    benchmark::DoNotOptimize(w.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_XYZtoQuaternion_Batch)->Arg(16)->Arg(256)->Arg(kSamples);
+
+void BM_QuaterniontoZYX_Reference(benchmark::State & state)
+{
+  const Eigen::Quaterniond q = referenceXYZtoQuaternion(10.0, -20.0, 30.0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(referenceQuaterniontoZYX(q.x(), q.y(), q.z(), q.w()));
+  }
+}
+BENCHMARK(BM_QuaterniontoZYX_Reference);
+
+void BM_QuaterniontoZYX(benchmark::State & state)
+{
+  const Eigen::Quaterniond q = referenceXYZtoQuaternion(10.0, -20.0, 30.0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(convertQuaterniontoZYX(q.x(), q.y(), q.z(), q.w()));
+  }
+}
+BENCHMARK(BM_QuaterniontoZYX);
+
+}  // namespace
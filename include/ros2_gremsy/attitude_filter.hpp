@@ -0,0 +1,63 @@
+#ifndef ROS2_GREMSY__ATTITUDE_FILTER_HPP_
+#define ROS2_GREMSY__ATTITUDE_FILTER_HPP_
+
+#include <cstdint>
+
+#include <Eigen/Dense>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Complementary filter fusing the gimbal gyro with the mount orientation
+ * The orientation is propagated with every new gyro sample read by the driver, holding
+ * its rate over the samples that were overwritten between two polls, and pulled towards
+ * the slower mount orientation reports with a first order time constant, so that
+ * the estimate follows the gyro at short time scales and the gimbal attitude
+ * estimate at long ones. Quaternions are in the convention of convertXYZtoQuaternion.
+ */
+class AttitudeFilter
+{
+public:
+  struct Config
+  {
+    /// Time constant in seconds of the correction towards the mount orientation
+    double time_constant = 0.5;
+    /// Signs mapping the gyro axes to the axes of the orientation quaternion
+    Eigen::Vector3d gyro_signs = Eigen::Vector3d(1.0, 1.0, -1.0);
+  };
+
+  void configure(const Config & config);
+
+  /**
+   * @brief Propagate the orientation with a gyro sample
+   * @param gyro Bias corrected angular velocity in rad/s
+   * @param time_usec Time of the sample, repeated samples are ignored
+   * @return True if the sample was new and the filter is initialized
+   */
+  bool predict(const Eigen::Vector3d & gyro, uint64_t time_usec);
+
+  /**
+   * @brief Correct the orientation with a mount orientation report
+   * @param orientation Orientation reported by the gimbal
+   * @param time_usec Receive time of the report, repeated reports are ignored
+   */
+  void correct(const Eigen::Quaterniond & orientation, uint64_t time_usec);
+
+  /// True once the first mount orientation has been received
+  bool initialized() const {return initialized_;}
+
+  const Eigen::Quaterniond & orientation() const {return orientation_;}
+
+private:
+  Config config_;
+
+  Eigen::Quaterniond orientation_ = Eigen::Quaterniond::Identity();
+  bool initialized_ = false;
+  uint64_t last_gyro_usec_ = 0;
+  uint64_t last_correction_usec_ = 0;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__ATTITUDE_FILTER_HPP_
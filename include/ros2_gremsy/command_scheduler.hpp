@@ -0,0 +1,149 @@
+#ifndef ROS2_GREMSY__COMMAND_SCHEDULER_HPP_
+#define ROS2_GREMSY__COMMAND_SCHEDULER_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <Eigen/Dense>
+
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Serializes the commands written to the gimbal
+ * Configuration commands (mode changes, axis modes, motor on/off) are queued and
+ * preempt the motion setpoints. Each configuration command waits for a COMMAND_ACK
+ * of its MAV_CMD from the gimbal. It succeeds when the result is MAV_RESULT_ACCEPTED,
+ * fails without retrying when the gimbal denies it, and is retried when it is
+ * temporarily rejected or the acknowledgement does not arrive in time. The ACKs of
+ * other commands, e.g. late ones of the setpoints, are ignored.
+ * Motion setpoints are not queued, only the latest one is sent.
+ */
+class CommandScheduler
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  /// Writes a configuration command to the gimbal
+  using CommandFunction = std::function<void ()>;
+  /// Writes a motion setpoint in degrees (x:roll, y:tilt, z:pan) to the gimbal
+  using SetpointFunction = std::function<void (const Eigen::Vector3d &)>;
+
+  /// Latest COMMAND_ACK received from the gimbal
+  struct Ack
+  {
+    /// Changes every time a COMMAND_ACK is received, e.g. its receive time
+    uint64_t stamp = 0;
+    /// MAV_CMD that is acknowledged
+    uint16_t command = 0;
+    /// MAV_RESULT of the command
+    uint8_t result = MAV_RESULT_ACCEPTED;
+  };
+  /// Returns the latest COMMAND_ACK
+  using AckFunction = std::function<Ack()>;
+
+  struct Config
+  {
+    /// Time to wait for the acknowledgement before resending
+    std::chrono::duration<double> ack_timeout{0.2};
+    /// Number of resends before the command is reported as failed
+    int max_retries = 3;
+  };
+
+  /// Command and acknowledgement statistics
+  struct Stats
+  {
+    uint64_t commands = 0;
+    uint64_t acked = 0;
+    uint64_t retries = 0;
+    /// Commands not acknowledged or rejected, after their retries
+    uint64_t failed = 0;
+    /// Failed commands the gimbal answered with a result other than accepted
+    uint64_t rejected = 0;
+    uint64_t setpoints = 0;
+    /// Acknowledgement round-trip times in milliseconds
+    double last_rtt_ms = 0.0;
+    double mean_rtt_ms = 0.0;
+    double max_rtt_ms = 0.0;
+  };
+
+  CommandScheduler(
+    const Config & config, SetpointFunction send_setpoint, AckFunction read_ack);
+  ~CommandScheduler();
+
+  /// Start the worker thread
+  void start();
+
+  /// Stop the worker thread, pending commands are reported as failed
+  void stop();
+
+  /**
+   * @brief Queue a configuration command
+   * @param name Name of the command for logging
+   * @param command MAV_CMD written by send, only its acknowledgements are accepted
+   * @param send Function writing the command to the gimbal
+   * @return Future set to true when the command was accepted, false if it failed
+   */
+  std::shared_future<bool> submitCommand(
+    const std::string & name, uint16_t command, CommandFunction send);
+
+  /// Replace the pending motion setpoint, it is sent once no configuration command is pending
+  void submitSetpoint(const Eigen::Vector3d & setpoint);
+
+  Stats stats() const;
+
+  /// Name of the command that failed last and why, empty if none failed
+  std::string lastFailedCommand() const;
+
+private:
+  struct Command
+  {
+    std::string name;
+    uint16_t command;
+    CommandFunction send;
+    std::promise<bool> result;
+  };
+
+  void run();
+
+  /// Send the command and wait for its acknowledgement, with retries
+  bool execute(Command & command, std::unique_lock<std::mutex> & lock);
+
+  /**
+   * @brief Wait for the acknowledgement of one attempt of a command
+   * @param command MAV_CMD of the command
+   * @param previous_stamp Stamp of the latest ACK before the command was sent
+   * @param deadline End of the acknowledgement timeout
+   * @return Result of the command, or nothing if no ACK of the command arrived in time
+   */
+  std::optional<uint8_t> waitForAck(
+    uint16_t command, uint64_t previous_stamp, Clock::time_point deadline);
+
+  Config config_;
+  SetpointFunction send_setpoint_;
+  AckFunction read_ack_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Command> commands_;
+  Eigen::Vector3d setpoint_;
+  bool has_setpoint_ = false;
+  bool running_ = false;
+  std::thread worker_;
+
+  Stats stats_;
+  std::string last_failed_command_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__COMMAND_SCHEDULER_HPP_
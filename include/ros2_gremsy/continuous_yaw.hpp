@@ -0,0 +1,78 @@
+#ifndef ROS2_GREMSY__CONTINUOUS_YAW_HPP_
+#define ROS2_GREMSY__CONTINUOUS_YAW_HPP_
+
+#include <cmath>
+
+#include "ros2_gremsy/utils.hpp"
+
+namespace ros2_gremsy
+{
+
+/// Angle equivalent to angle modulo 360 degrees that is the closest to reference
+inline double unwrapNear(double angle, double reference)
+{
+  return reference + wrapAngle(angle - reference);
+}
+
+/**
+ * @brief Pan angle reaching the goal by the shortest path from the current angle
+ * Among the angles equivalent to goal modulo 360 degrees, picks the closest one to
+ * current that is inside the mechanical range. If none is inside, the closest one is
+ * clamped to the range.
+ * @param goal Desired pan angle in degrees, any turn
+ * @param current Current continuous pan angle in degrees
+ * @param min_pan Mechanical range minimum in degrees
+ * @param max_pan Mechanical range maximum in degrees
+ * @return Pan angle in degrees inside [min_pan, max_pan]
+ */
+inline double shortestReachableYaw(double goal, double current, double min_pan, double max_pan)
+{
+  const double nearest = unwrapNear(goal, current);
+  if (nearest >= min_pan && nearest <= max_pan) {
+    return nearest;
+  }
+  // The other direction, one turn away, may still be reachable
+  const double other = nearest + (nearest > current ? -360.0 : 360.0);
+  if (other >= min_pan && other <= max_pan) {
+    return other;
+  }
+  return std::fmin(std::fmax(nearest, min_pan), max_pan);
+}
+
+/**
+ * @brief Continuous pan angle tracked from the wrapped encoder readings
+ * The encoder readings are unwrapped by assuming the pan moves less than
+ * half a turn between two readings. The first reading is taken as is, so the
+ * pan is assumed to start inside the turn the encoder reports, which holds if
+ * the gimbal was not turned past +-180 degrees before the tracking started.
+ */
+class ContinuousYaw
+{
+public:
+  /// Add an encoder reading in degrees
+  void update(double encoder_pan)
+  {
+    if (!initialized_) {
+      angle_ = encoder_pan;
+      initialized_ = true;
+    } else {
+      angle_ += wrapAngle(encoder_pan - last_reading_);
+    }
+    last_reading_ = encoder_pan;
+  }
+
+  /// True once a reading has been added
+  bool initialized() const {return initialized_;}
+
+  /// Continuous pan angle in degrees
+  double angle() const {return angle_;}
+
+private:
+  double angle_ = 0.0;
+  double last_reading_ = 0.0;
+  bool initialized_ = false;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__CONTINUOUS_YAW_HPP_
@@ -0,0 +1,210 @@
+#ifndef ROS2_GREMSY__DEVICE_TRAITS_HPP_
+#define ROS2_GREMSY__DEVICE_TRAITS_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <Eigen/Dense>
+#include <geometry_msgs/msg/vector3.hpp>
+
+#include "ros2_gremsy/continuous_yaw.hpp"
+#include "ros2_gremsy/utils.hpp"
+
+enum gremsy_model_t
+{
+  GREMSY_MIO = 0,
+  GREMSY_S1,
+  GREMSY_T3V3,
+  GREMSY_T7,
+  NUM_OF_MODELS
+};
+
+namespace ros2_gremsy
+{
+
+/// Bit of an axis input mode, modes are numbered as in the *_axis_input_mode parameters
+constexpr uint8_t axisInputModeBit(int mode)
+{
+  return static_cast<uint8_t>(1u << mode);
+}
+
+/// All of angle body frame, angular rate and angle absolute frame
+constexpr uint8_t ALL_AXIS_INPUT_MODES =
+  axisInputModeBit(0) | axisInputModeBit(1) | axisInputModeBit(2);
+/**
+ * @brief Angular rate and angle absolute frame, no angle body frame
+ * Per the gSDK documentation only the Pixy and T3V3 support the angle body frame
+ * mode on the pitch and yaw axes. It is not verified on the hardware, so other
+ * modes only cause a warning, the gimbal rejects the ones it does not support.
+ */
+constexpr uint8_t NO_BODY_FRAME_INPUT_MODES = axisInputModeBit(1) | axisInputModeBit(2);
+
+/// Model specific capabilities of a gimbal
+struct DeviceProfile
+{
+  const char * name;
+  /// Mechanical limits in degrees
+  double min_pan;
+  double max_pan;
+  double min_tilt;
+  double max_tilt;
+  double min_roll;
+  double max_roll;
+  /// Documented input modes of each axis, as axisInputModeBit masks
+  uint8_t pan_input_modes;
+  uint8_t tilt_input_modes;
+  uint8_t roll_input_modes;
+  /// Raw IMU scale factors, m/s^2 per accelerometer count and rad/s per gyro count,
+  /// assumed for every model, see NOMINAL_ACCEL_SCALE
+  double accel_scale;
+  double gyro_scale;
+};
+
+/**
+ * @brief Assumed raw IMU scale factors, for a +-8 g accelerometer and a +-2000 deg/s gyro
+ * Gremsy does not document the IMU ranges of any model. These are the 16 bit counts of
+ * an MPU-6000 class IMU at those ranges, and all models use them until measured, the
+ * imu_accel_scale and imu_gyro_scale parameters override them.
+ */
+constexpr double NOMINAL_ACCEL_SCALE = 9.80665 / 4096.0;
+constexpr double NOMINAL_GYRO_SCALE = DEG_TO_RAD / 16.4;
+
+/**
+ * @brief Compile-time profile of each gimbal model
+ * Adding a model only needs a new gremsy_model_t entry and a specialization
+ * with its profile, everything else is instantiated from the enum.
+ */
+template<gremsy_model_t Model>
+struct DeviceTraits;
+
+template<>
+struct DeviceTraits<GREMSY_MIO>
+{
+  static constexpr DeviceProfile profile = {
+    "MIO", -325.0, 325.0, -120.0, 120.0, -40.0, 40.0,
+    NO_BODY_FRAME_INPUT_MODES, NO_BODY_FRAME_INPUT_MODES, ALL_AXIS_INPUT_MODES,
+    NOMINAL_ACCEL_SCALE, NOMINAL_GYRO_SCALE};
+};
+
+template<>
+struct DeviceTraits<GREMSY_S1>
+{
+  static constexpr DeviceProfile profile = {
+    "S1", -345.0, 345.0, -120.0, 120.0, -45.0, 45.0,
+    NO_BODY_FRAME_INPUT_MODES, NO_BODY_FRAME_INPUT_MODES, ALL_AXIS_INPUT_MODES,
+    NOMINAL_ACCEL_SCALE, NOMINAL_GYRO_SCALE};
+};
+
+template<>
+struct DeviceTraits<GREMSY_T3V3>
+{
+  // The T3V3 also supports the angle body frame mode on the pan and tilt axes
+  static constexpr DeviceProfile profile = {
+    "T3V3", -345.0, 345.0, -120.0, 120.0, -45.0, 45.0,
+    ALL_AXIS_INPUT_MODES, ALL_AXIS_INPUT_MODES, ALL_AXIS_INPUT_MODES,
+    NOMINAL_ACCEL_SCALE, NOMINAL_GYRO_SCALE};
+};
+
+template<>
+struct DeviceTraits<GREMSY_T7>
+{
+  static constexpr DeviceProfile profile = {
+    "T7", -300.0, 300.0, -120.0, 120.0, -45.0, 45.0,
+    NO_BODY_FRAME_INPUT_MODES, NO_BODY_FRAME_INPUT_MODES, ALL_AXIS_INPUT_MODES,
+    NOMINAL_ACCEL_SCALE, NOMINAL_GYRO_SCALE};
+};
+
+/// Type carrying a model as a compile-time constant
+template<gremsy_model_t Model>
+using ModelTag = std::integral_constant<gremsy_model_t, Model>;
+
+/**
+ * @brief Call a generic function with the ModelTag of a runtime model
+ * @param model Model to dispatch on, out of range values use the last model
+ * @param function Callable taking a ModelTag, returning the same type for all models
+ */
+template<typename Function, int M = 0>
+decltype(auto) visitModel(gremsy_model_t model, Function && function)
+{
+  if constexpr (M + 1 < NUM_OF_MODELS) {
+    if (model != M) {
+      return visitModel<Function, M + 1>(model, std::forward<Function>(function));
+    }
+  }
+  return function(ModelTag<static_cast<gremsy_model_t>(M)>());
+}
+
+/// Profile of a runtime model
+inline DeviceProfile getDeviceProfile(gremsy_model_t model)
+{
+  return visitModel(model, [](auto tag) {return DeviceTraits<decltype(tag)::value>::profile;});
+}
+
+/// Checks of the profiles that must hold for every model
+template<gremsy_model_t Model>
+constexpr bool isValidProfile()
+{
+  constexpr DeviceProfile profile = DeviceTraits<Model>::profile;
+  return profile.min_pan < profile.max_pan && profile.min_tilt < profile.max_tilt &&
+         profile.min_roll < profile.max_roll &&
+         profile.accel_scale > 0.0 && profile.gyro_scale > 0.0 &&
+         (profile.pan_input_modes & axisInputModeBit(2)) &&
+         (profile.tilt_input_modes & axisInputModeBit(2)) &&
+         (profile.roll_input_modes & axisInputModeBit(2));
+}
+
+template<int... Models>
+constexpr bool areValidProfiles(std::integer_sequence<int, Models...>)
+{
+  return (isValidProfile<static_cast<gremsy_model_t>(Models)>() && ...);
+}
+
+static_assert(
+  areValidProfiles(std::make_integer_sequence<int, NUM_OF_MODELS>()),
+  "Every gimbal model needs a valid DeviceTraits profile, supporting the absolute angle mode");
+
+/**
+ * @brief Limit the desired orientation to the device specifications
+ * Enforce gimbal limits on the desired orientation, the limits are compile-time constants of the Model.
+ * @param goal Desired orientation in radians (x:roll, y:pitch, z:yaw)
+ * @param lock_yaw_to_vehicle If true, the yaw will be locked to the vehicle's yaw
+ * @param yaw_difference Mount yaw orientation absolute difference from mount yaw
+ * @param current_pan Continuous pan angle in degrees, in the frame of the returned yaw.
+ * If set, the yaw goes the shortest reachable way from it instead of being clamped.
+ * @return Vector3d of desired orientation in degrees (x:roll, y:pitch, z:yaw)
+ */
+template<gremsy_model_t Model>
+Eigen::Vector3d prepareGimbalMove(
+  const geometry_msgs::msg::Vector3 & goal,
+  const bool lock_yaw_to_vehicle = false, const double yaw_difference = 0.0,
+  const std::optional<double> current_pan = std::nullopt)
+{
+  constexpr DeviceProfile profile = DeviceTraits<Model>::profile;
+  const double yaw = RAD_TO_DEG * (goal.z + (lock_yaw_to_vehicle ? 0.0 : yaw_difference));
+  return Eigen::Vector3d(
+    std::fmin(std::fmax(RAD_TO_DEG * goal.x, profile.min_roll), profile.max_roll),
+    std::fmin(std::fmax(RAD_TO_DEG * goal.y, profile.min_tilt), profile.max_tilt),
+    current_pan ?
+    shortestReachableYaw(yaw, *current_pan, profile.min_pan, profile.max_pan) :
+    std::fmin(std::fmax(yaw, profile.min_pan), profile.max_pan));
+}
+
+/// prepareGimbalMove instantiated for one model
+using PrepareGimbalMoveFunction = Eigen::Vector3d (*)(
+  const geometry_msgs::msg::Vector3 &, const bool, const double, const std::optional<double>);
+
+/// prepareGimbalMove of a runtime model
+inline PrepareGimbalMoveFunction getPrepareGimbalMove(gremsy_model_t model)
+{
+  return visitModel(
+    model, [](auto tag) -> PrepareGimbalMoveFunction {
+      return &prepareGimbalMove<decltype(tag)::value>;
+    });
+}
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__DEVICE_TRAITS_HPP_
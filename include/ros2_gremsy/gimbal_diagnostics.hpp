@@ -0,0 +1,145 @@
+#ifndef ROS2_GREMSY__GIMBAL_DIAGNOSTICS_HPP_
+#define ROS2_GREMSY__GIMBAL_DIAGNOSTICS_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include <rclcpp/rclcpp.hpp>
+#include <diagnostic_updater/diagnostic_updater.hpp>
+
+#include "ros2_gremsy/command_scheduler.hpp"
+#include "ros2_gremsy/gimbal_state.hpp"
+#include "ros2_gremsy/stream_rate_controller.hpp"
+#include "ros2_gremsy/topic_qos.hpp"
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Publishes the health of the gimbal link and the driver on /diagnostics
+ * Reports the state and goal tick rates against their configured rates, the
+ * rates of the messages received from the gimbal, the utilization of the serial
+ * link, command statistics, heartbeat age, gimbal mode, the offset between the
+ * gimbal and host clocks, goal ticks that started late, and the QoS events of the topics.
+ */
+class GimbalDiagnostics
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config
+  {
+    /// Configured state_poll_rate and goal_push_rate in Hz
+    double state_rate = 50.0;
+    double goal_rate = 60.0;
+    /// Allowed relative deviation of the measured tick rates
+    double rate_tolerance = 0.1;
+    /// Heartbeat ages in seconds at which the link is reported as warning and error
+    double heartbeat_warn_age = 1.0;
+    double heartbeat_error_age = 3.0;
+    /// Fraction of late goal ticks at which a warning is reported
+    double max_late_goal_ratio = 0.01;
+    /// Jitter of the gimbal to host clock offset in seconds at which a warning is reported
+    double time_offset_jitter_warn = 0.02;
+    /// Baudrate of the serial link, and the utilization of either direction at which a
+    /// warning is reported
+    int baudrate = 115200;
+    double max_link_utilization = 0.8;
+    std::string hardware_id;
+  };
+
+  struct Sources
+  {
+    /// Mode of gimbal_status_t, read when the diagnostics are updated
+    std::function<int()> gimbal_mode;
+    /// Statistics of the command scheduler
+    std::function<CommandScheduler::Stats()> command_stats;
+    /// Bytes received and sent on the serial link, only known while the link tap is active
+    std::function<uint64_t()> rx_bytes;
+    std::function<uint64_t()> tx_bytes;
+    /// Why the link tap stopped, empty while it forwards or without a tap
+    std::function<std::string()> link_tap_error;
+    /// Stream rates requested from the gimbal, compared with the measured ones
+    std::function<StreamRateController::Rates()> stream_rates;
+    /// QoS events of the topics
+    std::function<QosEvents::Counts()> qos_events;
+  };
+
+  GimbalDiagnostics(rclcpp::Node * node, const Config & config, const Sources & sources);
+
+  /// Called by the state timer with every polled state
+  void stateTick(const GimbalState & state);
+
+  /// Called at the start of every goal timer tick
+  void goalTick();
+
+  /// Expect the state ticks at a new rate in Hz, from the callback group of the updater
+  void setStateRate(double rate);
+
+  /// Expect the goal ticks at a new rate in Hz, from the callback group of the updater
+  void setGoalRate(double rate);
+
+private:
+  void linkStatus(diagnostic_updater::DiagnosticStatusWrapper & stat);
+  void gimbalStatus(diagnostic_updater::DiagnosticStatusWrapper & stat);
+  void goalStatus(diagnostic_updater::DiagnosticStatusWrapper & stat);
+  void qosStatus(diagnostic_updater::DiagnosticStatusWrapper & stat);
+
+  /// Count a message if its receive stamp changed
+  static void countUpdate(uint64_t stamp, uint64_t & last_stamp, uint64_t & count);
+
+  Config config_;
+  Sources sources_;
+
+  double state_min_rate_;
+  double state_max_rate_;
+  double goal_min_rate_;
+  double goal_max_rate_;
+  diagnostic_updater::FrequencyStatus state_frequency_;
+  diagnostic_updater::FrequencyStatus goal_frequency_;
+
+  /// Protects everything below, written by the timers and read by the updater
+  std::mutex mutex_;
+
+  /// Received message counts and their last receive stamps
+  uint64_t imu_count_ = 0;
+  uint64_t mount_status_count_ = 0;
+  uint64_t mount_orientation_count_ = 0;
+  uint64_t heartbeat_count_ = 0;
+  GimbalState last_state_;
+  /// Counts at the previous update, for the rates
+  uint64_t last_imu_count_ = 0;
+  uint64_t last_mount_status_count_ = 0;
+  uint64_t last_mount_orientation_count_ = 0;
+  uint64_t last_heartbeat_count_ = 0;
+  uint64_t last_setpoints_ = 0;
+  uint64_t last_commands_ = 0;
+  uint64_t last_rx_bytes_ = 0;
+  uint64_t last_tx_bytes_ = 0;
+  Clock::time_point last_link_update_;
+
+  /// Host receive time minus gimbal time of the raw IMU, in microseconds
+  int64_t time_offset_usec_ = 0;
+  int64_t min_time_offset_usec_ = 0;
+  int64_t max_time_offset_usec_ = 0;
+  bool time_offset_valid_ = false;
+
+  /// Goal ticks since the previous update, and the ones that started late
+  Clock::time_point last_goal_tick_;
+  uint64_t goal_ticks_ = 0;
+  uint64_t late_goal_ticks_ = 0;
+  uint64_t total_late_goal_ticks_ = 0;
+  double max_goal_interval_ = 0.0;
+
+  /// QoS event counts at the previous update, only used by the updater
+  QosEvents::Counts last_qos_events_;
+
+  diagnostic_updater::Updater updater_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__GIMBAL_DIAGNOSTICS_HPP_
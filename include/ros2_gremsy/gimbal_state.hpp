@@ -0,0 +1,69 @@
+#ifndef ROS2_GREMSY__GIMBAL_STATE_HPP_
+#define ROS2_GREMSY__GIMBAL_STATE_HPP_
+
+#include <cstdint>
+
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Gimbal state read in one poll, with the receive time stamps of gSDK filled in
+ * The receive stamps are the get_time_usec() of gSDK when the message was parsed, in
+ * microseconds of the system clock since the epoch.
+ */
+struct GimbalState
+{
+  /// time_usec is the receive time in microseconds
+  mavlink_raw_imu_t raw_imu{};
+  /// Time of the raw IMU sample on the gimbal clock in microseconds
+  uint64_t raw_imu_device_time_usec = 0;
+  mavlink_mount_status_t mount_status{};
+  /// Receive time of the mount status in microseconds
+  uint64_t mount_status_time_usec = 0;
+  /// time_boot_ms is the time on the gimbal clock in milliseconds, as sent
+  mavlink_mount_orientation_t mount_orientation{};
+  /// Receive time of the mount orientation in microseconds
+  uint64_t mount_orientation_time_usec = 0;
+  /// Receive time of the last heartbeat in microseconds
+  uint64_t heartbeat_time_usec = 0;
+  /// Mode of gimbal_status_t
+  int mode = 0;
+};
+
+/**
+ * @brief Read the IMU, mount status and mount orientation of one update generation
+ * gSDK stamps each message when it is received. The stamps are read before and
+ * after the messages, and the read is repeated if the receive thread updated one
+ * of them in between, so that the messages always match their stamps. This is only
+ * a consistency retry over the gSDK getters, each of which still takes the gSDK lock,
+ * so it does not reduce the locking per poll.
+ * @param gimbal Interface to read from
+ * @param max_attempts Reads before the last one is returned even if it was overlapped
+ */
+GimbalState readGimbalState(Gimbal_Interface & gimbal, int max_attempts = 3);
+
+/// Latest COMMAND_ACK received by gSDK
+struct CommandAck
+{
+  /// Receive time in microseconds, 0 until the first acknowledgement
+  uint64_t time_usec = 0;
+  mavlink_command_ack_t message{};
+};
+
+/**
+ * @brief Read the latest COMMAND_ACK with its receive time stamp
+ * gSDK only has getters for the results of some commands and does not expose the lock
+ * of its current messages, so the whole message is copied without it while the receive
+ * thread may write it. The message is copied twice, and the read is repeated unless both
+ * copies match and no new acknowledgement was stamped in between. This narrows the race,
+ * it does not remove it.
+ * @param gimbal Interface to read from
+ * @param max_attempts Reads before the last one is returned even if it was overlapped
+ */
+CommandAck readCommandAck(Gimbal_Interface & gimbal, int max_attempts = 3);
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__GIMBAL_STATE_HPP_
@@ -0,0 +1,159 @@
+#ifndef ROS2_GREMSY__GIMBAL_STATE_PUBLISHER_HPP_
+#define ROS2_GREMSY__GIMBAL_STATE_PUBLISHER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+#include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <geometry_msgs/msg/quaternion_stamped.hpp>
+
+#include "ros2_gremsy/msg/gimbal_state.hpp"
+#include "ros2_gremsy/gimbal_state.hpp"
+#include "ros2_gremsy/imu_calibration.hpp"
+#include "ros2_gremsy/attitude_filter.hpp"
+#include "ros2_gremsy/stream_rate_controller.hpp"
+#include "ros2_gremsy/topic_qos.hpp"
+#include "ros2_gremsy/tracing.hpp"
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Converts a polled GimbalState to ROS messages and publishes them
+ * The whole state goes in one message on ~/state, published when a poll has a new
+ * sample. The per-sensor topics are published on every poll if legacy_topics is set.
+ * Owns the IMU calibration and the attitude filter, so that the whole publish
+ * cycle of the state timer runs without a gimbal, e.g. in the benchmarks.
+ * The messages are allocated once and reused, with the frame ids set at construction,
+ * so that a steady state cycle does not allocate before the middleware. The messages
+ * have a frame_id string, so they cannot be loaned by the middleware.
+ */
+class GimbalStatePublisher
+{
+public:
+  struct Config
+  {
+    ImuCalibration::Config imu;
+    /// Publish the fused orientation on ~/mount_orientation_fused
+    bool attitude_filter = false;
+    AttitudeFilter::Config attitude;
+    /// Stamp the messages with the node clock instead of the receive time stamps
+    bool use_ros_time = true;
+    std::string frame_id = "gimbal_link";
+    /// Publish ~/imu, ~/encoder, ~/mount_orientation_global and ~/mount_orientation_local
+    bool legacy_topics = true;
+    /// QoS of the topics, before the overrides from the parameters
+    rclcpp::QoS qos = stateQos();
+    /// Counts the QoS events and declares the QoS override parameters of the topics if set,
+    /// outlives the publisher
+    QosEvents * qos_events = nullptr;
+  };
+
+  /// Create the publishers on the node
+  GimbalStatePublisher(rclcpp::Node & node, const Config & config);
+
+  /// Publish the state of one poll, and the IMU, encoder and mount orientations
+  void publish(const GimbalState & state);
+
+  /**
+   * @brief Fill the messages from one poll without publishing them
+   * @return True if a fused orientation is due for this poll
+   */
+  bool update(const GimbalState & state);
+
+  /// Whether each gimbal stream feeds a topic that has subscribers
+  std::array<bool, StreamRateController::NUM_STREAMS> consumedStreams() const;
+
+  const sensor_msgs::msg::Imu & imuMessage() const {return imu_msg_;}
+  const geometry_msgs::msg::Vector3Stamped & encoderMessage() const {return encoder_msg_;}
+  const msg::GimbalState & stateMessage() const {return state_msg_;}
+
+private:
+  /// Stamps of the messages of one poll
+  struct Stamps
+  {
+    rclcpp::Time imu;
+    rclcpp::Time encoder;
+    rclcpp::Time orientation;
+  };
+
+  /// Time of a gSDK receive stamp in microseconds, see GimbalState
+  static rclcpp::Time receiveTime(uint64_t time_usec);
+
+  /// Stamps of one poll, all the same node time if use_ros_time is set
+  Stamps stamps(const GimbalState & state) const;
+
+  void fillImu(
+    const mavlink_raw_imu_t & imu_mav, const rclcpp::Time & time, sensor_msgs::msg::Imu & msg);
+  void fillEncoder(
+    const mavlink_mount_status_t & mount_status, const rclcpp::Time & time,
+    geometry_msgs::msg::Vector3Stamped & msg);
+  void fillOrientation(
+    const mavlink_mount_orientation_t & mount_orientation, double yaw, const rclcpp::Time & time,
+    geometry_msgs::msg::QuaternionStamped & msg);
+
+  /// Fill the combined message with the receive times of the samples
+  void fillState(const GimbalState & state, const rclcpp::Time & time, msg::GimbalState & msg);
+
+  /// True if the poll has a sample that was not published on ~/state yet
+  bool newSamples(const GimbalState & state);
+
+  /// Run the attitude filter on one poll, true if a fused orientation is due
+  bool updateAttitude(const GimbalState & state);
+
+  /**
+   * @brief Fill and publish one of the reused messages
+   * @param fill Function filling everything but the frame id of the message
+   */
+  template<typename MessageT, typename FillFunction>
+  void publishMessage(
+    rclcpp::Publisher<MessageT> & publisher, MessageT & message, FillFunction && fill)
+  {
+    fill(message);
+    GREMSY_TRACEPOINT(state_publish, publisher.get_publisher_handle().get(), &message);
+    publisher.publish(message);
+  }
+
+  Config config_;
+  rclcpp::Clock::SharedPtr clock_;
+
+  ImuCalibration imu_calibration_;
+  AttitudeFilter attitude_filter_;
+
+  /// Messages reused on every cycle
+  sensor_msgs::msg::Imu imu_msg_;
+  geometry_msgs::msg::Vector3Stamped encoder_msg_;
+  geometry_msgs::msg::QuaternionStamped orientation_global_msg_;
+  geometry_msgs::msg::QuaternionStamped orientation_local_msg_;
+  geometry_msgs::msg::QuaternionStamped orientation_fused_msg_;
+  msg::GimbalState state_msg_;
+
+  /// Receive stamps of the samples last published on ~/state
+  std::array<uint64_t, 3> last_stamps_{};
+
+  /// Publisher for the whole gimbal state
+  rclcpp::Publisher<msg::GimbalState>::SharedPtr state_pub_;
+
+  /// Publisher for IMU data from gremsy
+  rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr imu_pub_;
+
+  /// Publisher for encoder Vector3 data from gremsy
+  rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>::SharedPtr encoder_pub_;
+
+  /// Publisher for mount orientation global yaw Quaternion data
+  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr mount_orientation_global_pub_;
+
+  /// Publisher for mount orientation local yaw Quaternion data
+  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr mount_orientation_local_pub_;
+
+  /// Publisher for the fused mount orientation in the global frame
+  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr mount_orientation_fused_pub_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__GIMBAL_STATE_PUBLISHER_HPP_
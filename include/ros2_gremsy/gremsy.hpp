@@ -1,29 +1,42 @@
 #ifndef ROS2_GREMSY_HPP_
 #define ROS2_GREMSY_HPP_
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp_action/rclcpp_action.hpp>
 #include <sensor_msgs/msg/imu.hpp>
 #include <geometry_msgs/msg/vector3_stamped.hpp>
 #include <geometry_msgs/msg/quaternion_stamped.hpp>
 #include <std_srvs/srv/set_bool.hpp>
 #include <tf2_eigen/tf2_eigen.h>
 
+#include "ros2_gremsy/action/move_to.hpp"
 #include "ros2_gremsy/utils.hpp"
+#include "ros2_gremsy/device_traits.hpp"
+#include "ros2_gremsy/setpoint_shaper.hpp"
+#include "ros2_gremsy/setpoint_filter.hpp"
+#include "ros2_gremsy/command_scheduler.hpp"
+#include "ros2_gremsy/gimbal_state_publisher.hpp"
+#include "ros2_gremsy/seqlock.hpp"
+#include "ros2_gremsy/gimbal_diagnostics.hpp"
+#include "ros2_gremsy/link_capture.hpp"
+#include "ros2_gremsy/link_tap.hpp"
+#include "ros2_gremsy/serial_link.hpp"
+#include "ros2_gremsy/stream_rate_controller.hpp"
+#include "ros2_gremsy/poll_rate_adapter.hpp"
+#include "ros2_gremsy/periodic_thread.hpp"
+#include "ros2_gremsy/topic_qos.hpp"
 #include <../../gSDK/src/gimbal_interface.h>
 #include <../../gSDK/src/serial_port.h>
 
 #define DEG_TO_RAD (M_PI / 180.0)
 #define RAD_TO_DEG (180.0 / M_PI)
 
-enum gremsy_model_t
-{
-  GREMSY_MIO = 0,
-  GREMSY_S1,
-  GREMSY_T3V3,
-  GREMSY_T7,
-  NUM_OF_MODELS
-};
-
 
 namespace ros2_gremsy
 {
@@ -31,11 +44,28 @@ namespace ros2_gremsy
 class GremsyDriver : public rclcpp::Node
 {
 public:
+  using MoveTo = ros2_gremsy::action::MoveTo;
+  using GoalHandleMoveTo = rclcpp_action::ServerGoalHandle<MoveTo>;
+
   GremsyDriver(const rclcpp::NodeOptions & options);
   GremsyDriver(const rclcpp::NodeOptions & options, const std::string & serial_port);
   ~GremsyDriver();
 
 private:
+  /// Value of a parameter by name, the current one or a new one being validated
+  using ParameterLookup = std::function<rclcpp::Parameter(const std::string &)>;
+
+  /// Gimbal state shared by the state timer with the goal timer and the action threads
+  struct DriverState
+  {
+    GimbalState gimbal;
+    /// Mount yaw orientation absolute difference from mount yaw, in radians
+    double yaw_difference;
+    /// Multi-turn pan angle tracked from the encoder, valid if pan_initialized
+    double pan_angle;
+    bool pan_initialized;
+  };
+
   /**
    * @brief Desired mount orientation callback Vector3
    * @param msg Vector3Stamped message
@@ -58,77 +88,152 @@ private:
   void enableLockModeCallback(const std::shared_ptr<std_srvs::srv::SetBool::Request> request,
                               const std::shared_ptr<std_srvs::srv::SetBool::Response> response);
 
+  /**
+   * @brief MoveTo action goal callback
+   * Goals with a non-positive tolerance are rejected.
+   */
+  rclcpp_action::GoalResponse handleMoveToGoal(
+    const rclcpp_action::GoalUUID & uuid,
+    std::shared_ptr<const MoveTo::Goal> goal);
+
+  /// MoveTo action cancel callback, cancelling is always accepted
+  rclcpp_action::CancelResponse handleMoveToCancel(
+    const std::shared_ptr<GoalHandleMoveTo> goal_handle);
+
+  /**
+   * @brief MoveTo action accepted callback
+   * The new goal preempts the active one, whose thread is joined, and is executed in a
+   * thread of its own.
+   */
+  void handleMoveToAccepted(const std::shared_ptr<GoalHandleMoveTo> goal_handle);
+
+  /**
+   * @brief Send the MoveTo target to the gimbal and wait for the orientation to converge
+   * Succeeds once the error stays inside the tolerance for the settle time, aborts if the
+   * goal is preempted or the driver is destroyed.
+   */
+  void executeMoveTo(const std::shared_ptr<GoalHandleMoveTo> goal_handle);
+
+  /// Store a new goal for the goal timer, without allocating
+  void setGoal(const geometry_msgs::msg::Vector3 & goal);
+
   /// Declare Parameters for the nodes
   void declareParameters();
 
   /**
-   * @brief State of the gimbal will be pooled by a timer
+   * @brief Validate and apply parameter changes at runtime
+   * Changes are applied only if they are all valid. Timers are recreated at the new rates,
+   * and the new gimbal and axes modes are queued to the gimbal.
+   */
+  rcl_interfaces::msg::SetParametersResult parametersCallback(
+    const std::vector<rclcpp::Parameter> & parameters);
+
+  /// First axis whose input mode is not documented for the device, nullptr if all are
+  const char * undocumentedAxisInputMode(const ParameterLookup & parameter) const;
+
+  /// Setpoint shaper limits from the parameters, without limits for the axes in angular rate
+  /// mode, false if they do not have 3 values
+  bool readShaperLimits(const ParameterLookup & parameter, SetpointShaper::Limits & limits) const;
+
+  /// Setpoint deadband and keepalive from the parameters, false if the deadband does not
+  /// have 3 values, in which case it is left unchanged
+  bool readFilterConfig(const ParameterLookup & parameter, SetpointFilter::Config & config) const;
+
+  /// Adaptive poll rate bounds from the parameters
+  PollRateAdapter::Config pollRateAdapterConfig(const ParameterLookup & parameter) const;
+
+  /**
+   * @brief State of the gimbal will be pooled by a timer, or by the state publisher thread
    * This callback will get IMU, encoders, and mount orientation
    */
   void gimbalStateTimerCallback();
 
+  /// Retune the state poll rate to the measured stream rates
+  void adaptPollRate();
+
+  /// Create the state timer at a rate in Hz, replacing the current one, or retune the
+  /// state publisher thread
+  void createPollTimer(double rate);
+
+  /// Period of a rate in Hz
+  static std::chrono::nanoseconds periodOf(double rate);
+
+  /// Create the goal timer at a rate in Hz, replacing the current one
+  void createGoalTimer(double rate);
+
   /**
    * @brief This callback will get the last command from ROS2 topic,
    * and send it to the gimbal
    */
   void gimbalGoalTimerCallback();
 
+  /**
+   * @brief Send a setpoint in degrees to the gimbal
+   * Setpoints within the deadband of the last sent one are suppressed.
+   * @param setpoint Vector3d of orientation in degrees (x:roll, y:pitch, z:yaw)
+   */
+  void sendGimbalMove(const Eigen::Vector3d & setpoint);
 
-  /// Struct for device specific limits
-  struct
-  {
-    const gremsy_model_t device_name;
-    const double min_pan;
-    const double max_pan;
-    const double min_tilt;
-    const double max_tilt;
-    const double min_roll;
-    const double max_roll;
-  } device_specifications_[NUM_OF_MODELS] = {
-    {GREMSY_MIO, -325.0, 325.0, -120.0, 120.0, -40.0, 40.0},
-    {GREMSY_S1, -345.0, 345.0, -120.0, 120.0, -45.0, 45.0},
-    {GREMSY_T3V3, -345.0, 345.0, -120.0, 120.0, -45.0, 45.0},
-    {GREMSY_T7, -300.0, 300.0, -120.0, 120.0, -45.0, 45.0},
-  };
+  /**
+   * @brief Measured mount orientation in the same frame as prepareGimbalMove output
+   * Used as the starting point of the setpoint shaper.
+   * @param state Snapshot of the gimbal state
+   * @return Vector3d of orientation in degrees (x:roll, y:pitch, z:yaw)
+   */
+  Eigen::Vector3d measuredGimbalMove(const DriverState & state) const;
 
   /**
-   * @brief Limit the desired orientation to the device specifications
-   * Enforce gimbal limits on the desired orientation
-   * @param msg Vector3Stamped desired orientation message
-   * @param model gremsy_model_t for specific limits of the device
-   * @param lock_yaw_to_vehicle If true, the yaw will be locked to the vehicle's yaw
-   * @param yaw_difference Mount yaw orientation absolute difference from mount yaw
-   * @return Vector3d of desired orientation in degrees (x:roll, y:pitch, z:yaw)
-   *
+   * @brief Continuous pan angle from the encoder in the same frame as prepareGimbalMove output
+   * @param state Snapshot of the gimbal state
+   * @return Pan angle in degrees, or nothing if continuous yaw tracking is disabled or has no data yet
    */
-  Eigen::Vector3d prepareGimbalMove(
-    const geometry_msgs::msg::Vector3Stamped::SharedPtr & msg, const int model,
-    const bool lock_yaw_to_vehicle = false, const double yaw_difference = 0.0)
-  {
-    Eigen::Vector3d gimbal_move(msg->vector.x, msg->vector.y, msg->vector.z);
-    gimbal_move.x() = std::fmin(
-      std::fmax(
-        RAD_TO_DEG * msg->vector.x,
-        device_specifications_[model].min_roll),
-      device_specifications_[model].max_roll);
-
-    gimbal_move.y() = std::fmin(
-      std::fmax(
-        RAD_TO_DEG * msg->vector.y,
-        device_specifications_[model].min_tilt),
-      device_specifications_[model].max_tilt);
-
-    gimbal_move.z() = std::fmin(
-      std::fmax(
-        RAD_TO_DEG * (msg->vector.z + (lock_yaw_to_vehicle ? 0.0 : yaw_difference)),
-        device_specifications_[model].min_pan),
-      device_specifications_[model].max_pan);
-
-    return gimbal_move;
-  }
+  std::optional<double> currentPan(const DriverState & state) const;
+
+  /**
+   * @brief Send a configuration command through the command scheduler and wait for its ACK
+   * @param name Name of the command for logging
+   * @param command MAV_CMD the function writes, e.g. MAV_CMD_USER_2 for set_gimbal_mode
+   * @param send Function writing the command to the gimbal
+   * @return true if the gimbal accepted the command
+   */
+  bool sendGimbalCommand(
+    const std::string & name, uint16_t command, CommandScheduler::CommandFunction send);
+
+  /// Queue a configuration command through the command scheduler without waiting for its ACK
+  std::shared_future<bool> submitGimbalCommand(
+    const std::string & name, uint16_t command, CommandScheduler::CommandFunction send);
+
+  /// Command setting the gimbal mode, a MAV_CMD_USER_2, see convertIntGimbalMode
+  CommandScheduler::CommandFunction gimbalModeCommand(int mode);
+
+  /// Command setting the input mode and stabilization of each axis from the members,
+  /// a MAV_CMD_DO_MOUNT_CONFIGURE
+  CommandScheduler::CommandFunction axesModeCommand();
+
+  /// Stream rates from the parameters
+  StreamRateController::Config streamRateConfig(const ParameterLookup & parameter) const;
+
+  /// Request the stream rates that changed with the subscribers of the state topics
+  void updateStreamRates();
+
+
+  /// Node handle identifying the driver in the tracepoints
+  const void * trace_handle_;
 
   /// Device
   gremsy_model_t device_id_;
+  /// Limits and capabilities of the device
+  DeviceProfile device_profile_;
+  /// Goal limiting instantiated for the device, see prepareGimbalMove
+  PrepareGimbalMoveFunction prepare_gimbal_move_;
+
+  /// Raw link capture, set if link_capture is enabled
+  std::unique_ptr<LinkCapture> link_capture_;
+  /// Forwards the link between gSDK and the device for the capture, destroyed before it
+  std::unique_ptr<LinkTap> link_tap_;
+
+  /// QoS events of the topics, destroyed after the publishers and subscriptions
+  std::unique_ptr<QosEvents> qos_events_;
 
   /// Serial port object
   Serial_Port * serial_port_;
@@ -136,18 +241,19 @@ private:
   /// Gimbal interface object
   Gimbal_Interface * gimbal_interface_;
 
+  /// Orders the commands written to the gimbal and tracks their acknowledgements
+  std::unique_ptr<CommandScheduler> command_scheduler_;
 
-  /// Publisher for IMU data from gremsy
-  rclcpp::Publisher<sensor_msgs::msg::Imu>::SharedPtr imu_pub_;
-
-  /// Publisher for encoder Vector3 data from gremsy
-  rclcpp::Publisher<geometry_msgs::msg::Vector3Stamped>::SharedPtr encoder_pub_;
+  /// Publishes the polled gimbal state
+  std::unique_ptr<GimbalStatePublisher> state_publisher_;
 
-  /// Publisher for mount orientation global yaw Quaternion data
-  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr mount_orientation_global_pub_;
+  /// Rates requested for the gimbal streams, set if request_stream_rates is enabled
+  std::unique_ptr<StreamRateController> stream_rates_;
+  /// Timer following the subscribers of the state topics for the stream rates
+  rclcpp::TimerBase::SharedPtr stream_rate_timer_;
 
-  /// Publisher for mount orientation local yaw Quaternion data
-  rclcpp::Publisher<geometry_msgs::msg::QuaternionStamped>::SharedPtr mount_orientation_local_pub_;
+  /// Link, rate and latency health on /diagnostics
+  std::unique_ptr<GimbalDiagnostics> diagnostics_;
 
   /// Subscriber for desired mount orientation Vector3
   rclcpp::Subscription<geometry_msgs::msg::Vector3Stamped>::SharedPtr desired_mount_orientation_sub_;
@@ -158,28 +264,65 @@ private:
   /// Service for gimbal mode change
   rclcpp::Service<std_srvs::srv::SetBool>::SharedPtr enable_lock_mode_service_;
 
-  /// Store goals
-  geometry_msgs::msg::Vector3Stamped::SharedPtr goal_;
-  /// Store yaw difference
-  double yaw_difference_ = 0;
+  /// Action server for moving to an orientation and waiting for convergence
+  rclcpp_action::Server<MoveTo>::SharedPtr move_to_server_;
+  /// MoveTo goal being executed, preempted by new goals
+  std::shared_ptr<GoalHandleMoveTo> active_move_to_;
+  /// Thread executing the MoveTo goals, one at a time, joined before the next one starts
+  std::thread move_to_thread_;
+  /// Set by the destructor to abort the MoveTo goal being executed
+  std::atomic<bool> move_to_stop_{false};
+  /// Callback group for services waiting on acknowledgements, so they do not block the timers
+  rclcpp::CallbackGroup::SharedPtr command_callback_group_;
 
-  /// Timer for pooling data from gremsy
+  /// Store goals
+  geometry_msgs::msg::Vector3 goal_;
+  /// True if goal_ has not been sent to the gimbal yet
+  bool goal_pending_ = false;
+  /// Protects goal_ and active_move_to_, which are also set from the action threads
+  std::mutex goal_mutex_;
+  /// Last gimbal state, written by the state timer only, readers never block it
+  SeqLock<DriverState> driver_state_;
+  /// Multi-turn pan angle tracked from the encoder, only used by the state timer
+  ContinuousYaw pan_tracker_;
+
+  /// Jerk-limited profile between consecutive goals
+  SetpointShaper shaper_;
+  /// Deadband and keepalive for the setpoints sent to the gimbal
+  SetpointFilter setpoint_filter_;
+
+  /// Timer for pooling data from gremsy, unused with the state publisher thread
   rclcpp::TimerBase::SharedPtr pool_timer_;
+  /// Polls and publishes the state outside of the executor, set if state_publisher_thread
+  /// is enabled
+  std::unique_ptr<PeriodicThread> state_thread_;
+  /// Timer retuning the poll rate, set if adaptive_poll_rate is enabled
+  rclcpp::TimerBase::SharedPtr poll_rate_timer_;
+  /// Poll rate following the gimbal streams
+  PollRateAdapter poll_rate_adapter_;
+  /// Protects poll_rate_adapter_, polled from the state publisher thread if enabled
+  std::mutex poll_rate_mutex_;
   /// Timer for sending goals to gremsy
   rclcpp::TimerBase::SharedPtr goal_timer_;
 
+  /// Applies the parameter changes at runtime
+  OnSetParametersCallbackHandle::SharedPtr parameters_callback_handle_;
+
   /// Serial COM port to use
   std::string com_port_;
 
   /// Serial baud rate to use
   int baud_rate_;
 
-  /// Rate in which the gimbal data is polled and published
-  double state_poll_rate_;
+  /// Rate in which the gimbal data is polled and published, the initial rate if adaptive.
+  /// The parameters can change it while the action threads read it
+  std::atomic<double> state_poll_rate_;
+  /// Follow the rate of the gimbal streams with the poll rate
+  std::atomic<bool> adaptive_poll_rate_;
   /// Rate in which the gimbal are pushed to the gimbal
   double goal_push_rate_;
-  /// Control mode of the gimbal
-  int gimbal_mode_;
+  /// Control mode of the gimbal, set by the lock mode service and the parameters
+  std::atomic<int> gimbal_mode_;
   /// Input mode of the gimbals tilt axis
   int tilt_axis_input_mode_;
   /// Input mode of the gimbals tilt roll
@@ -193,9 +336,13 @@ private:
   /// Input mode of the gimbals tilt pan
   bool pan_axis_stabilize_;
   /// Uses the yaw relative to the gimbal mount to prevent drift issues. Only a light stabilization is applied.
-  bool lock_yaw_to_vehicle_;
+  std::atomic<bool> lock_yaw_to_vehicle_;
   /// Time source for the published messages, ros node time is true
   bool use_ros_time_;
+  /// Shape the goals with a jerk-limited profile instead of sending them in one step
+  bool setpoint_shaping_;
+  /// Send the pan the shortest reachable way from the current encoder angle
+  std::atomic<bool> continuous_yaw_;
 
 };
 
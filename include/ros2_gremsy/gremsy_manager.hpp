@@ -0,0 +1,48 @@
+#ifndef ROS2_GREMSY__GREMSY_MANAGER_HPP_
+#define ROS2_GREMSY__GREMSY_MANAGER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "ros2_gremsy/gremsy.hpp"
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Creates one GremsyDriver per configured gimbal in the same process
+ * Each gimbal is described by the entries at the same index of the com_ports,
+ * baudrates, device_ids and namespaces parameters. Driver i is named ros2_gremsy_<i>,
+ * and does not see the command line arguments of the process. The drivers start
+ * concurrently, the ones whose gimbal does not turn on in time are left out.
+ * All drivers are meant to be spun by a single executor, and share the DDS
+ * participant of the process.
+ */
+class GremsyManager : public rclcpp::Node
+{
+public:
+  explicit GremsyManager(const rclcpp::NodeOptions & options);
+
+  /// Drivers of the configured gimbals that started
+  const std::vector<std::shared_ptr<GremsyDriver>> & drivers() const {return drivers_;}
+
+  /// Number of executor threads shared by all drivers
+  int executorThreads() const {return executor_threads_;}
+
+private:
+  /// Declare Parameters for the nodes
+  void declareParameters();
+
+  /// Drivers, one for each gimbal
+  std::vector<std::shared_ptr<GremsyDriver>> drivers_;
+
+  /// Number of executor threads shared by all drivers
+  int executor_threads_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__GREMSY_MANAGER_HPP_
@@ -0,0 +1,80 @@
+#ifndef ROS2_GREMSY__IMU_CALIBRATION_HPP_
+#define ROS2_GREMSY__IMU_CALIBRATION_HPP_
+
+#include <cstdint>
+
+#include <Eigen/Dense>
+#include <sensor_msgs/msg/imu.hpp>
+
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Converts the raw IMU counts of the gimbal to a calibrated sensor_msgs/Imu
+ * The counts are scaled to m/s^2 and rad/s, the gyro bias is estimated online
+ * while the gimbal is stationary, and the covariances are filled. The stationary
+ * detection uses the raw rates, so a slow turn below the threshold can still leak
+ * into the bias, which is bounded by max_gyro_bias. The gimbal
+ * does not provide an orientation with the raw IMU, so it is marked as unavailable
+ * as described in REP-145.
+ */
+class ImuCalibration
+{
+public:
+  struct Config
+  {
+    /// m/s^2 per accelerometer count
+    double accel_scale = 0.0;
+    /// rad/s per gyro count
+    double gyro_scale = 0.0;
+    /// Standard deviations used for the diagonal covariances
+    double accel_stddev = 0.0;
+    double gyro_stddev = 0.0;
+    /// Estimate the gyro bias while stationary
+    bool estimate_gyro_bias = true;
+    /// Maximum raw angular rate in rad/s to be considered stationary
+    double stationary_gyro_threshold = 0.05;
+    /// Maximum deviation of the acceleration norm from gravity in m/s^2 to be considered stationary
+    double stationary_accel_threshold = 0.5;
+    /// Time in seconds the gimbal has to be stationary before the bias is updated
+    double stationary_time = 1.0;
+    /// Time constant in seconds of the bias estimate
+    double bias_time_constant = 10.0;
+    /// Maximum magnitude of the bias estimate in rad/s
+    double max_gyro_bias = 0.02;
+  };
+
+  void configure(const Config & config);
+
+  /**
+   * @brief Fill the IMU message from a raw IMU sample, the header is left untouched
+   * @param raw Raw IMU message from the gimbal, time_usec is used to detect new samples
+   * @param imu Message to fill
+   */
+  void apply(const mavlink_raw_imu_t & raw, sensor_msgs::msg::Imu & imu);
+
+  /// Calibrated angular velocity of a raw IMU sample in rad/s, with the bias removed
+  Eigen::Vector3d angularVelocity(const mavlink_raw_imu_t & raw) const;
+
+  /// Current gyro bias estimate in rad/s
+  const Eigen::Vector3d & gyroBias() const {return gyro_bias_;}
+
+  /// True if the last samples were stationary for at least the stationary time
+  bool stationary() const {return stationary_for_ >= config_.stationary_time;}
+
+private:
+  /// Update the stationary detection and the bias estimate with a new sample
+  void update(const Eigen::Vector3d & accel, const Eigen::Vector3d & gyro, double dt);
+
+  Config config_;
+
+  Eigen::Vector3d gyro_bias_ = Eigen::Vector3d::Zero();
+  double stationary_for_ = 0.0;
+  uint64_t last_sample_usec_ = 0;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__IMU_CALIBRATION_HPP_
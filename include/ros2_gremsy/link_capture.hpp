@@ -0,0 +1,137 @@
+#ifndef ROS2_GREMSY__LINK_CAPTURE_HPP_
+#define ROS2_GREMSY__LINK_CAPTURE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <thread>
+
+#include "ros2_gremsy/spsc_byte_ring.hpp"
+
+namespace ros2_gremsy
+{
+
+/// Direction of a chunk of the serial link, as seen from the driver
+enum class LinkDirection : uint8_t
+{
+  RX = 0,
+  TX = 1,
+};
+
+/**
+ * @brief Header of a captured chunk, followed by its bytes
+ * A capture file starts with CAPTURE_FILE_MAGIC and CAPTURE_FILE_VERSION, followed
+ * by the records back to back in host byte order.
+ */
+struct CaptureRecordHeader
+{
+  /// Steady clock time of the chunk in nanoseconds
+  uint64_t timestamp_ns;
+  uint32_t length;
+  LinkDirection direction;
+  uint8_t reserved[3];
+};
+static_assert(sizeof(CaptureRecordHeader) == 16, "The capture format needs a 16 byte header");
+
+constexpr char CAPTURE_FILE_MAGIC[8] = {'G', 'R', 'M', 'S', 'Y', 'C', 'A', 'P'};
+constexpr uint32_t CAPTURE_FILE_VERSION = 1;
+
+/**
+ * @brief Records the raw bytes of the serial link to rotating files
+ * The link thread copies each chunk into a lock-free ring, and a background
+ * thread writes the ring to disk. Chunks that do not fit in the ring are dropped
+ * and counted, the link thread never waits for the disk.
+ */
+class LinkCapture
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config
+  {
+    /// Directory of the capture files, created if missing
+    std::string directory = "/tmp/ros2_gremsy_capture";
+    /// Prefix of the file names, followed by the start time and a sequence number
+    std::string prefix = "gremsy";
+    /// Size in bytes after which a new file is started
+    std::size_t max_file_size = 64u << 20;
+    /// Number of files kept, the oldest ones are deleted, 0 keeps all
+    std::size_t max_files = 8;
+    /// Size of the ring in bytes
+    std::size_t buffer_size = 4u << 20;
+    /// Period of the background writer
+    std::chrono::milliseconds flush_period{20};
+  };
+
+  struct Stats
+  {
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    uint64_t dropped_records = 0;
+    uint64_t dropped_bytes = 0;
+    uint64_t files = 0;
+  };
+
+  /// Starts the background writer, throws std::runtime_error if the directory cannot be used
+  explicit LinkCapture(const Config & config);
+  /// Writes the remaining records and closes the file
+  ~LinkCapture();
+
+  /// Capture a chunk, only called from the one link thread
+  void record(LinkDirection direction, const uint8_t * data, std::size_t size)
+  {
+    record(direction, data, size, Clock::now());
+  }
+
+  void record(
+    LinkDirection direction, const uint8_t * data, std::size_t size, Clock::time_point time)
+  {
+    CaptureRecordHeader header{};
+    header.timestamp_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+    header.length = static_cast<uint32_t>(size);
+    header.direction = direction;
+    if (ring_.write(&header, sizeof(header), data, size)) {
+      records_.fetch_add(1, std::memory_order_relaxed);
+      bytes_.fetch_add(size, std::memory_order_relaxed);
+    } else {
+      dropped_records_.fetch_add(1, std::memory_order_relaxed);
+      dropped_bytes_.fetch_add(size, std::memory_order_relaxed);
+    }
+  }
+
+  Stats stats() const;
+
+private:
+  void run();
+  /// Write everything in the ring, rotating the file if it is full
+  void flush();
+  void openFile();
+  void removeOldFiles();
+
+  Config config_;
+  SpscByteRing ring_;
+
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> dropped_records_{0};
+  std::atomic<uint64_t> dropped_bytes_{0};
+  std::atomic<uint64_t> files_{0};
+
+  /// Only used by the writer thread, after construction
+  std::FILE * file_ = nullptr;
+  std::size_t file_size_ = 0;
+  /// Files written so far, oldest first
+  std::deque<std::string> file_paths_;
+  std::string start_time_;
+
+  std::atomic<bool> running_{true};
+  std::thread writer_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__LINK_CAPTURE_HPP_
@@ -0,0 +1,115 @@
+#ifndef ROS2_GREMSY__LINK_REPLAY_HPP_
+#define ROS2_GREMSY__LINK_REPLAY_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ros2_gremsy/link_capture.hpp"
+
+namespace ros2_gremsy
+{
+
+/// Reads the records of a capture file written by LinkCapture
+class CaptureReader
+{
+public:
+  /// @throw std::runtime_error if the file cannot be opened or is not a capture file
+  explicit CaptureReader(const std::string & path);
+  ~CaptureReader();
+
+  CaptureReader(const CaptureReader &) = delete;
+  CaptureReader & operator=(const CaptureReader &) = delete;
+
+  /**
+   * @brief Read the next record
+   * @param data Resized to the bytes of the record, reusing its capacity
+   * @return false at the end of the file, or at a record cut off by the end of the capture
+   */
+  bool next(CaptureRecordHeader & header, std::vector<uint8_t> & data);
+
+private:
+  std::FILE * file_;
+};
+
+/**
+ * @brief Plays the received side of captures into a file descriptor
+ * Stands in for the gimbal on the master side of a pseudo terminal, so that gSDK and
+ * the driver run unchanged on recorded traffic. The bytes written by gSDK are read and
+ * discarded. Played as fast as possible, the pseudo terminal only accepts bytes as fast
+ * as gSDK parses them.
+ */
+class LinkReplay
+{
+public:
+  struct Config
+  {
+    /// Capture files, played in order
+    std::vector<std::string> files;
+    /// Speed relative to the recorded timing, 0 plays as fast as possible
+    double rate = 1.0;
+    /// Start again with the first file after the last one
+    bool loop = false;
+  };
+
+  struct Stats
+  {
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    /// MAVLink frames in the played bytes, counted by the replay, not by gSDK
+    uint64_t frames = 0;
+  };
+
+  /**
+   * @brief Take over the file descriptor and start playing
+   * @throw std::runtime_error if one of the files is not a capture file
+   */
+  LinkReplay(int fd, const Config & config);
+  /// Stops playing and closes the file descriptor
+  ~LinkReplay();
+
+  LinkReplay(const LinkReplay &) = delete;
+  LinkReplay & operator=(const LinkReplay &) = delete;
+
+  /// Change the speed, the recorded timing continues from the current record
+  void setRate(double rate) {rate_.store(rate, std::memory_order_relaxed);}
+
+  /// True once the last record has been played or the fd failed, never if looping
+  bool finished() const {return finished_.load(std::memory_order_acquire);}
+
+  Stats stats() const;
+
+private:
+  void run();
+  /// Play one file, false if stopped
+  bool play(const std::string & path);
+  /// Wait until the fd is writable or the deadline, discarding what gSDK writes, false if stopped
+  bool wait(int timeout_ms, bool writable);
+  /// Write all bytes, false if stopped
+  bool writeAll(const uint8_t * data, std::size_t size);
+
+  int fd_;
+  Config config_;
+  /// Wakes up the replay thread to stop it
+  int stop_fd_[2];
+  std::atomic<double> rate_;
+  std::atomic<bool> finished_{false};
+
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> frames_{0};
+
+  /// Recorded time and host time of the record the timing is anchored to, and its rate
+  uint64_t anchor_record_ns_ = 0;
+  LinkCapture::Clock::time_point anchor_time_;
+  double anchor_rate_ = -1.0;
+
+  std::thread thread_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__LINK_REPLAY_HPP_
@@ -0,0 +1,98 @@
+#ifndef ROS2_GREMSY__LINK_TAP_HPP_
+#define ROS2_GREMSY__LINK_TAP_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ros2_gremsy/link_capture.hpp"
+
+namespace ros2_gremsy
+{
+
+class MavlinkParser;
+
+/**
+ * @brief Sits between gSDK and the serial device to observe the raw link
+ * gSDK opens the slave side of a pseudo terminal instead of the device, and the
+ * tap thread forwards the bytes between the pseudo terminal and the device in
+ * both directions, passing every chunk to the capture on the way. A read or write
+ * error on the device stops the tap, which is then reported with its reason.
+ */
+class LinkTap
+{
+public:
+  /// Called once from the tap thread when it stops on an error, with the reason
+  using StopCallback = std::function<void (const std::string &)>;
+
+  /**
+   * @brief Take over the file descriptors and start forwarding
+   * @param device_fd Serial device, or any descriptor standing in for it
+   * @param pty_fd Master side of the pseudo terminal opened by gSDK
+   * @param capture Capture of the chunks, may be null
+   * @param on_stop Called if the tap stops on an error, may be empty
+   */
+  LinkTap(
+    int device_fd, int pty_fd, LinkCapture * capture, StopCallback on_stop = StopCallback());
+  /// Stops forwarding and closes both descriptors
+  ~LinkTap();
+
+  LinkTap(const LinkTap &) = delete;
+  LinkTap & operator=(const LinkTap &) = delete;
+
+  uint64_t rxBytes() const {return rx_bytes_.load(std::memory_order_relaxed);}
+  uint64_t txBytes() const {return tx_bytes_.load(std::memory_order_relaxed);}
+
+  /// True once the tap stopped forwarding on an error, and the stop callback returned
+  bool stopped() const {return stopped_.load(std::memory_order_acquire);}
+
+  /// Why the tap stopped, empty while it is forwarding
+  std::string stopReason() const;
+
+  /**
+   * @brief Open and configure a serial device in raw mode
+   * @throw std::runtime_error if the device cannot be opened or the baudrate is not supported
+   */
+  static int openSerialDevice(const std::string & path, int baudrate);
+
+  /**
+   * @brief Open a pseudo terminal in raw mode
+   * @param slave_path Set to the path of the slave side, for gSDK to open
+   * @throw std::runtime_error if no pseudo terminal is available
+   * @return Master side of the pseudo terminal
+   */
+  static int openPseudoTerminal(std::string & slave_path);
+
+private:
+  void run();
+  /// Read a chunk from one side and write it to the other, false on a fatal error
+  bool forward(int from, int to, LinkDirection direction, std::atomic<uint64_t> & counter);
+  /// Record why the tap stops and report it
+  void fail(const std::string & reason);
+
+  int device_fd_;
+  int pty_fd_;
+  /// Wakes up the tap thread to stop it
+  int stop_fd_[2];
+  LinkCapture * capture_;
+  StopCallback on_stop_;
+
+  std::atomic<uint64_t> rx_bytes_{0};
+  std::atomic<uint64_t> tx_bytes_{0};
+  /// Frames of the received bytes for the tracepoints, only with tracing enabled
+  std::unique_ptr<MavlinkParser> rx_parser_;
+
+  mutable std::mutex stop_mutex_;
+  std::string stop_reason_;
+  std::atomic<bool> stopped_{false};
+
+  std::thread thread_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__LINK_TAP_HPP_
@@ -0,0 +1,38 @@
+#ifndef ROS2_GREMSY__MAVLINK_PARSER_HPP_
+#define ROS2_GREMSY__MAVLINK_PARSER_HPP_
+
+#include <cstdint>
+
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief MAVLink frame parser with a state of its own
+ * mavlink_parse_char keeps the state of each channel in globals, shared by every parser
+ * of the process on that channel, e.g. the probes and link taps of the drivers started
+ * together by the manager. Frames with a bad checksum are dropped.
+ */
+class MavlinkParser
+{
+public:
+  /// Parse one byte, true if it completes a valid frame, which is then in message()
+  bool parse(uint8_t byte)
+  {
+    return mavlink_frame_char_buffer(&buffer_, &status_, byte, &message_, &message_status_) ==
+           MAVLINK_FRAMING_OK;
+  }
+
+  const mavlink_message_t & message() const {return message_;}
+
+private:
+  mavlink_message_t buffer_{};
+  mavlink_status_t status_{};
+  mavlink_message_t message_{};
+  mavlink_status_t message_status_{};
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__MAVLINK_PARSER_HPP_
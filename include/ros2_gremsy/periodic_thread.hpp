@@ -0,0 +1,80 @@
+#ifndef ROS2_GREMSY__PERIODIC_THREAD_HPP_
+#define ROS2_GREMSY__PERIODIC_THREAD_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Calls a function at a fixed period from a thread of its own
+ * The thread sleeps with clock_nanosleep until absolute deadlines, so that the period
+ * does not drift with the duration of the calls, and wakes up without going through an
+ * executor. It can run with a real-time priority and be pinned to CPUs. Ticks missed
+ * because a call overran are dropped instead of being run back to back.
+ */
+class PeriodicThread
+{
+public:
+  using Clock = std::chrono::steady_clock;
+  /// Called at each tick with its deadline
+  using Callback = std::function<void (Clock::time_point deadline)>;
+
+  struct Config
+  {
+    /// SCHED_FIFO priority from 1 to 99, 0 keeps the default scheduling
+    int priority = 0;
+    /// CPUs the thread may run on, empty for any
+    std::vector<int> cpus;
+  };
+
+  struct Stats
+  {
+    uint64_t ticks = 0;
+    /// Ticks dropped because the previous call was still running at their deadline
+    uint64_t overruns = 0;
+  };
+
+  PeriodicThread(const Config & config, Callback callback);
+  /// Stops the thread
+  ~PeriodicThread();
+
+  PeriodicThread(const PeriodicThread &) = delete;
+  PeriodicThread & operator=(const PeriodicThread &) = delete;
+
+  /**
+   * @brief Start calling the callback, the first tick is one period from now
+   * @return false if the priority or the affinity could not be set, e.g. without
+   * CAP_SYS_NICE, the thread then runs with the default scheduling
+   */
+  bool start(std::chrono::nanoseconds period);
+
+  /// Stop the thread, waits for up to one period
+  void stop();
+
+  /// Change the period from the next tick, thread safe
+  void setPeriod(std::chrono::nanoseconds period);
+
+  Stats stats() const;
+
+private:
+  void run();
+
+  Config config_;
+  Callback callback_;
+
+  std::atomic<int64_t> period_ns_{0};
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> ticks_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::thread thread_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__PERIODIC_THREAD_HPP_
@@ -0,0 +1,73 @@
+#ifndef ROS2_GREMSY__POLL_RATE_ADAPTER_HPP_
+#define ROS2_GREMSY__POLL_RATE_ADAPTER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "ros2_gremsy/gimbal_state.hpp"
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Follows the rate of the gimbal streams with the state poll rate
+ * Counts the new samples of the raw IMU, mount status and mount orientation seen by
+ * the polls. While some polls find no new sample, the polls see every sample and the
+ * counts are the stream rates, and the poll rate is set to the fastest stream rate
+ * times the margin. If every poll finds a new sample, the stream may be faster than
+ * the polls, so the poll rate is raised by the probe factor to find out.
+ * Not thread safe, the caller serializes poll, adapt and configure.
+ */
+class PollRateAdapter
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config
+  {
+    /// Bounds of the poll rate in Hz
+    double min_rate = 10.0;
+    double max_rate = 200.0;
+    /// Poll rate relative to the fastest stream, above 1 so that no sample is missed
+    double margin = 1.25;
+    /// Relative change of the poll rate below which it is kept, to avoid retuning on jitter
+    double hysteresis = 0.1;
+    /// Factor the poll rate is raised by while a stream is as fast as the polls
+    double probe_factor = 1.5;
+  };
+
+  /// Start over at the given poll rate
+  void configure(const Config & config, double rate, Clock::time_point now);
+
+  /// Count the new samples of a polled state
+  void poll(const GimbalState & state);
+
+  /**
+   * @brief Compute the poll rate from the polls since the previous call
+   * @return The poll rate to use, unchanged if there were too few polls or no samples
+   */
+  double adapt(Clock::time_point now);
+
+  /// Current poll rate in Hz
+  double rate() const {return rate_;}
+
+  /// Rate in Hz of the fastest stream measured by the last adapt, a lower bound while probing
+  double streamRate() const {return stream_rate_;}
+
+private:
+  static constexpr int kStreams = 3;
+
+  Config config_;
+  double rate_ = 50.0;
+  double stream_rate_ = 0.0;
+
+  Clock::time_point last_adapt_;
+  uint64_t polls_ = 0;
+  std::array<uint64_t, kStreams> samples_{};
+  std::array<uint64_t, kStreams> last_stamps_{};
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__POLL_RATE_ADAPTER_HPP_
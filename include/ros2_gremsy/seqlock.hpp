@@ -0,0 +1,62 @@
+#ifndef ROS2_GREMSY__SEQLOCK_HPP_
+#define ROS2_GREMSY__SEQLOCK_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Sequence lock for a trivially copyable value with a single writer
+ * The writer never waits. Readers copy the value and retry if a write overlapped,
+ * so a reader always sees a value from one store().
+ */
+template<typename T>
+class SeqLock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+  SeqLock()
+  : value_() {}
+
+  /// Publish a new value, only one thread may store
+  void store(const T & value)
+  {
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    // An odd sequence marks a write in progress
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(static_cast<void *>(&value_), &value, sizeof(T));
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /// Copy of the last stored value, safe from any thread
+  T load() const
+  {
+    T copy;
+    uint32_t before;
+    uint32_t after;
+    do {
+      before = sequence_.load(std::memory_order_acquire);
+      std::memcpy(static_cast<void *>(&copy), &value_, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence_.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+    return copy;
+  }
+
+  /// Number of stores so far
+  uint32_t version() const {return sequence_.load(std::memory_order_acquire) / 2;}
+
+private:
+  std::atomic<uint32_t> sequence_{0};
+  T value_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__SEQLOCK_HPP_
@@ -0,0 +1,46 @@
+#ifndef ROS2_GREMSY__SERIAL_LINK_HPP_
+#define ROS2_GREMSY__SERIAL_LINK_HPP_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ros2_gremsy
+{
+
+/// Baudrates gSDK can configure the serial port with
+constexpr int SUPPORTED_BAUDRATES[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+
+constexpr bool isSupportedBaudrate(int baudrate)
+{
+  for (const int supported : SUPPORTED_BAUDRATES) {
+    if (baudrate == supported) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Bytes per second carried by a baudrate, with the 10 bits per byte of 8N1 framing
+constexpr double linkBytesPerSecond(int baudrate)
+{
+  return baudrate / 10.0;
+}
+
+/**
+ * @brief Find the baudrate at which the gimbal sends heartbeats
+ * Listens at each candidate in order for a heartbeat with a valid checksum.
+ * Garbage at a wrong baudrate never passes the checksum.
+ * @param port Serial device
+ * @param candidates Baudrates to try, unsupported ones are skipped
+ * @param timeout Time to listen at each baudrate, longer than the heartbeat period
+ * @throw std::runtime_error if the device cannot be opened
+ * @return First candidate with a heartbeat, or 0 if there is none
+ */
+int probeBaudrate(
+  const std::string & port, const std::vector<int> & candidates,
+  std::chrono::milliseconds timeout);
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__SERIAL_LINK_HPP_
@@ -0,0 +1,90 @@
+#ifndef ROS2_GREMSY__SETPOINT_FILTER_HPP_
+#define ROS2_GREMSY__SETPOINT_FILTER_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+#include <Eigen/Dense>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Deadband and change suppression for the setpoints sent to the gimbal
+ * A setpoint is only sent if it differs from the last sent one by more than the
+ * deadband on at least one axis. While the gimbal is following a moving goal,
+ * the threshold is lowered by the hysteresis factor so that tracking stays smooth.
+ * Suppressed setpoints are resent as a keepalive after a configurable period.
+ * All values are in degrees (x:roll, y:tilt, z:pan), same as prepareGimbalMove.
+ */
+class SetpointFilter
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config
+  {
+    /// Per axis deadband in degrees, zero disables suppression of that axis
+    Eigen::Vector3d deadband = Eigen::Vector3d::Zero();
+    /// Fraction of the deadband removed while the goal is moving, 0.0 - 1.0
+    double hysteresis = 0.0;
+    /// Resend the latest setpoint after this period without commands, zero disables it
+    std::chrono::duration<double> keepalive_period{0.0};
+  };
+
+  /// Number of setpoints per outcome
+  struct Counters
+  {
+    uint64_t sent = 0;
+    uint64_t suppressed = 0;
+    uint64_t keepalive = 0;
+  };
+
+  void configure(const Config & config);
+
+  /**
+   * @brief Decide whether a new setpoint must be sent
+   * @param setpoint Requested setpoint in degrees
+   * @param now Current time
+   * @return true if the setpoint should be sent, the filter then records it as sent
+   */
+  bool accept(const Eigen::Vector3d & setpoint, Clock::time_point now);
+
+  /**
+   * @brief Check if the keepalive has to be sent
+   * @param now Current time
+   * @return true if the latest setpoint should be resent, the filter then records it as sent
+   */
+  bool keepalive(Clock::time_point now);
+
+  /**
+   * @brief Check if a suppressed setpoint is still to be sent, e.g. at the end of a profile
+   * @param now Current time
+   * @return true if the latest setpoint differs from the last sent one and should be sent,
+   *   the filter then records it as sent
+   */
+  bool flush(Clock::time_point now);
+
+  /// Latest requested setpoint, sent or not
+  const Eigen::Vector3d & latest() const {return latest_;}
+
+  const Counters & counters() const {return counters_;}
+
+private:
+  void markSent(Clock::time_point now);
+
+  Config config_;
+  Counters counters_;
+
+  Eigen::Vector3d latest_ = Eigen::Vector3d::Zero();
+  Eigen::Vector3d last_sent_ = Eigen::Vector3d::Zero();
+  Clock::time_point last_sent_time_;
+  bool has_sent_ = false;
+  bool has_pending_ = false;
+  /// Previous setpoint exceeded the deadband, so the goal is moving
+  bool moving_ = false;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__SETPOINT_FILTER_HPP_
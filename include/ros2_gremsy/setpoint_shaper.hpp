@@ -0,0 +1,82 @@
+#ifndef ROS2_GREMSY__SETPOINT_SHAPER_HPP_
+#define ROS2_GREMSY__SETPOINT_SHAPER_HPP_
+
+#include <Eigen/Dense>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Jerk-limited setpoint generator for the gimbal goals
+ * Instead of sending a new target to the gimbal in one step, the shaper moves
+ * an internal setpoint towards the target with an S-curve profile, limited
+ * per axis in velocity, acceleration and jerk. All values are in degrees
+ * (x:roll, y:tilt, z:pan), same as prepareGimbalMove.
+ */
+class SetpointShaper
+{
+public:
+  /// Per axis limits, in deg/s, deg/s^2 and deg/s^3
+  struct Limits
+  {
+    Eigen::Vector3d velocity;
+    Eigen::Vector3d acceleration;
+    Eigen::Vector3d jerk;
+  };
+
+  SetpointShaper();
+
+  /// Set the limits of the generated profile. Non-positive limits disable shaping of that axis.
+  void setLimits(const Limits & limits);
+
+  /**
+   * @brief Check that the limits can be followed at the tick of the shaper
+   * One tick at full jerk must stay within the acceleration limit, j * dt <= a, and
+   * within the velocity limit, j * dt^2 / 2 <= v, otherwise the shaped axes cannot
+   * reach the limits in whole ticks. Axes without shaping are not checked.
+   * @param dt Time step in seconds, normally 1 / goal_push_rate
+   */
+  static bool validLimits(const Limits & limits, double dt);
+
+  /// Start the profile at the given position, at rest
+  void reset(const Eigen::Vector3d & position);
+
+  /// Set a new target. The shaper must be initialized with reset() first
+  void setTarget(const Eigen::Vector3d & target);
+
+  /**
+   * @brief Advance the profile by one tick
+   * @param dt Time step in seconds, normally 1 / goal_push_rate
+   * @return The next setpoint to send to the gimbal
+   */
+  const Eigen::Vector3d & step(double dt);
+
+  /// True once reset() has been called
+  bool initialized() const {return initialized_;}
+
+  /// True if the setpoint has reached the target and is at rest
+  bool settled() const {return settled_;}
+
+  const Eigen::Vector3d & position() const {return position_;}
+  const Eigen::Vector3d & velocity() const {return velocity_;}
+  const Eigen::Vector3d & acceleration() const {return acceleration_;}
+  const Eigen::Vector3d & target() const {return target_;}
+
+private:
+  /// Advance a single axis, returns true if the axis is at rest on the target
+  bool stepAxis(int axis, double dt);
+
+  Limits limits_;
+
+  Eigen::Vector3d position_;
+  Eigen::Vector3d velocity_;
+  Eigen::Vector3d acceleration_;
+  Eigen::Vector3d target_;
+
+  bool initialized_ = false;
+  bool settled_ = true;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__SETPOINT_SHAPER_HPP_
@@ -0,0 +1,108 @@
+#ifndef ROS2_GREMSY__SPSC_BYTE_RING_HPP_
+#define ROS2_GREMSY__SPSC_BYTE_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Lock-free byte ring for one producer and one consumer thread
+ * The producer writes whole records, which the consumer sees either completely
+ * or not at all. Nothing blocks: a write that does not fit is rejected.
+ */
+class SpscByteRing
+{
+public:
+  /// @param capacity Size in bytes, rounded up to a power of two
+  explicit SpscByteRing(std::size_t capacity)
+  : capacity_(roundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1),
+    buffer_(new uint8_t[capacity_]) {}
+
+  std::size_t capacity() const {return capacity_;}
+
+  /**
+   * @brief Append a record made of two parts, e.g. a header and a payload
+   * Only called from the producer thread.
+   * @return False if the ring does not have room for the whole record
+   */
+  bool write(const void * first, std::size_t first_size, const void * second, std::size_t second_size)
+  {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t size = first_size + second_size;
+    if (capacity_ - (head - cached_tail_) < size) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (capacity_ - (head - cached_tail_) < size) {
+        return false;
+      }
+    }
+    copyIn(head, first, first_size);
+    copyIn(head + first_size, second, second_size);
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pass everything written so far to the sink and release it
+   * Only called from the consumer thread.
+   * @param sink Called with up to two contiguous spans, as sink(const uint8_t *, std::size_t)
+   * @return Number of bytes read
+   */
+  template<typename Sink>
+  std::size_t read(Sink && sink)
+  {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const std::size_t size = static_cast<std::size_t>(head - tail);
+    if (size == 0) {
+      return 0;
+    }
+    const std::size_t offset = static_cast<std::size_t>(tail & mask_);
+    const std::size_t first = size < capacity_ - offset ? size : capacity_ - offset;
+    sink(buffer_.get() + offset, first);
+    if (first < size) {
+      sink(buffer_.get(), size - first);
+    }
+    tail_.store(head, std::memory_order_release);
+    return size;
+  }
+
+private:
+  static std::size_t roundUpToPowerOfTwo(std::size_t value)
+  {
+    std::size_t result = 64;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  void copyIn(uint64_t position, const void * data, std::size_t size)
+  {
+    if (size == 0) {
+      return;
+    }
+    const std::size_t offset = static_cast<std::size_t>(position & mask_);
+    const std::size_t first = size < capacity_ - offset ? size : capacity_ - offset;
+    std::memcpy(buffer_.get() + offset, data, first);
+    std::memcpy(buffer_.get(), static_cast<const uint8_t *>(data) + first, size - first);
+  }
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<uint8_t[]> buffer_;
+
+  /// Written by the producer, with its last seen tail to avoid touching the consumer's line
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t cached_tail_ = 0;
+  /// Written by the consumer
+  alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__SPSC_BYTE_RING_HPP_
@@ -0,0 +1,81 @@
+#ifndef ROS2_GREMSY__STREAM_RATE_CONTROLLER_HPP_
+#define ROS2_GREMSY__STREAM_RATE_CONTROLLER_HPP_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace ros2_gremsy
+{
+
+/**
+ * @brief Decides the rates requested from the gimbal for the streams the driver reads
+ * Each stream is requested at its configured rate while something consumes it, and at
+ * the idle rate otherwise, to free link bandwidth and parser time. A request is only
+ * sent when the rate to request changes. A request the gimbal does not accept, e.g.
+ * answering MAV_RESULT_UNSUPPORTED, is not repeated until the next configure, so that firmware without the command does not
+ * keep the command queue busy.
+ */
+class StreamRateController
+{
+public:
+  enum Stream
+  {
+    RAW_IMU = 0,
+    MOUNT_STATUS,
+    MOUNT_ORIENTATION,
+    NUM_STREAMS
+  };
+
+  using Rates = std::array<double, NUM_STREAMS>;
+
+  struct Config
+  {
+    /// Rate in Hz of each consumed stream, negative leaves the stream to the gimbal
+    Rates rates = {-1.0, -1.0, -1.0};
+    /// Rate in Hz of the streams nobody consumes, 0 turns them off, negative keeps the
+    /// configured rates
+    double idle_rate = 1.0;
+  };
+
+  /**
+   * @brief Function requesting a stream rate from the gimbal
+   * @param message_id MAVLink message id of the stream
+   * @param rate Rate in Hz, 0 to turn the stream off
+   * @return true if the gimbal accepted the request
+   */
+  using RequestFunction = std::function<bool (uint32_t message_id, double rate)>;
+
+  explicit StreamRateController(RequestFunction request);
+
+  /// Set new rates, the changed ones are requested with the next update, and the failed
+  /// requests are tried again
+  void configure(const Config & config);
+
+  /**
+   * @brief Request the rates that changed
+   * @param consumed Whether each stream has a consumer
+   * @return false if one of the requests was not accepted
+   */
+  bool update(const std::array<bool, NUM_STREAMS> & consumed);
+
+  /// Rates requested and accepted, negative for the streams left to the gimbal
+  Rates requested() const;
+
+  static uint32_t messageId(Stream stream);
+  static const char * name(Stream stream);
+
+private:
+  RequestFunction request_;
+
+  /// Protects the members below, updated and read from different threads
+  mutable std::mutex mutex_;
+  Config config_;
+  Rates requested_ = {-1.0, -1.0, -1.0};
+  std::array<bool, NUM_STREAMS> failed_ = {false, false, false};
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__STREAM_RATE_CONTROLLER_HPP_
@@ -0,0 +1,75 @@
+#ifndef ROS2_GREMSY__TOPIC_QOS_HPP_
+#define ROS2_GREMSY__TOPIC_QOS_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <rclcpp/rclcpp.hpp>
+
+namespace ros2_gremsy
+{
+
+/// Default QoS of the state topics, best effort so that a slow subscriber or a lossy link
+/// drops samples instead of blocking the newer ones with retransmissions
+inline rclcpp::QoS stateQos()
+{
+  return rclcpp::SensorDataQoS();
+}
+
+/// Default QoS of the goal topics, only the latest goal matters
+inline rclcpp::QoS goalQos()
+{
+  return rclcpp::QoS(rclcpp::KeepLast(1));
+}
+
+/**
+ * @brief Counts the QoS events of the driver topics for the diagnostics
+ * The publishers and subscriptions created with its options also get parameters
+ * overriding their QoS, qos_overrides.<topic>.publisher.<policy> and
+ * qos_overrides.<topic>.subscription.<policy>, read when they are created.
+ * Deadline and liveliness events only occur once a deadline or a liveliness lease
+ * duration is set.
+ */
+class QosEvents
+{
+public:
+  struct Counts
+  {
+    /// Deadlines missed by the publishers and by the publishers of the subscribed goals
+    uint64_t deadlines_missed = 0;
+    /// Liveliness lost by the publishers, or by the publishers of the subscribed goals
+    uint64_t liveliness_lost = 0;
+    /// Endpoints not matched because of incompatible QoS
+    uint64_t incompatible_qos = 0;
+    /// Topic of the latest event, empty if there was none
+    std::string last_topic;
+  };
+
+  explicit QosEvents(const rclcpp::Logger & logger);
+
+  /// Options of a publisher, with its QoS overrides and event callbacks
+  rclcpp::PublisherOptions publisherOptions(const std::string & topic);
+
+  /// Options of a subscription, with its QoS overrides and event callbacks
+  rclcpp::SubscriptionOptions subscriptionOptions(const std::string & topic);
+
+  Counts counts() const;
+
+private:
+  void count(std::atomic<uint64_t> & counter, const std::string & topic, uint64_t change);
+
+  rclcpp::Logger logger_;
+
+  std::atomic<uint64_t> deadlines_missed_{0};
+  std::atomic<uint64_t> liveliness_lost_{0};
+  std::atomic<uint64_t> incompatible_qos_{0};
+  /// Protects last_topic_
+  mutable std::mutex mutex_;
+  std::string last_topic_;
+};
+
+}  // namespace ros2_gremsy
+
+#endif  // ROS2_GREMSY__TOPIC_QOS_HPP_
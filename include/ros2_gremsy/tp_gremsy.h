@@ -0,0 +1,131 @@
+// LTTng tracepoint provider of the driver, only included when tracing is enabled.
+// See tracing.hpp for the macro to use in the code.
+
+#undef TRACEPOINT_PROVIDER
+#define TRACEPOINT_PROVIDER ros2_gremsy
+
+#undef TRACEPOINT_INCLUDE
+#define TRACEPOINT_INCLUDE "ros2_gremsy/tp_gremsy.h"
+
+#if !defined(ROS2_GREMSY__TP_GREMSY_H_) || defined(TRACEPOINT_HEADER_MULTI_READ)
+#define ROS2_GREMSY__TP_GREMSY_H_
+
+#include <lttng/tracepoint.h>
+
+#include <stdint.h>
+
+// Bytes read from the serial link, emitted by the link tap so only with the link capture
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  serial_read,
+  TP_ARGS(
+    const void *, link_handle_arg,
+    uint64_t, bytes_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, link_handle, link_handle_arg)
+    ctf_integer(uint64_t, bytes, bytes_arg)
+  )
+)
+
+// MAVLink frame decoded from the serial link, emitted by the link tap so only with the link capture
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  mavlink_frame,
+  TP_ARGS(
+    const void *, link_handle_arg,
+    uint32_t, message_id_arg,
+    uint8_t, sequence_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, link_handle, link_handle_arg)
+    ctf_integer(uint32_t, message_id, message_id_arg)
+    ctf_integer(uint8_t, sequence, sequence_arg)
+  )
+)
+
+// Bytes or a command written to the serial link
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  serial_write,
+  TP_ARGS(
+    const void *, node_handle_arg,
+    const char *, command_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, node_handle, node_handle_arg)
+    ctf_string(command, command_arg)
+  )
+)
+
+// Gimbal state snapshot taken by the state timer, with the receive stamps
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  state_snapshot,
+  TP_ARGS(
+    const void *, node_handle_arg,
+    uint64_t, raw_imu_stamp_arg,
+    uint64_t, mount_status_stamp_arg,
+    uint64_t, mount_orientation_stamp_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, node_handle, node_handle_arg)
+    ctf_integer(uint64_t, raw_imu_stamp, raw_imu_stamp_arg)
+    ctf_integer(uint64_t, mount_status_stamp, mount_status_stamp_arg)
+    ctf_integer(uint64_t, mount_orientation_stamp, mount_orientation_stamp_arg)
+  )
+)
+
+// State message handed to rclcpp, the handles match the rclcpp_publish tracepoint
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  state_publish,
+  TP_ARGS(
+    const void *, publisher_handle_arg,
+    const void *, message_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, publisher_handle, publisher_handle_arg)
+    ctf_integer_hex(const void *, message, message_arg)
+  )
+)
+
+// Goal received from a topic or the MoveTo action, in radians
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  goal_received,
+  TP_ARGS(
+    const void *, node_handle_arg,
+    double, x_arg,
+    double, y_arg,
+    double, z_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, node_handle, node_handle_arg)
+    ctf_float(double, x, x_arg)
+    ctf_float(double, y, y_arg)
+    ctf_float(double, z, z_arg)
+  )
+)
+
+// Setpoint handed to the command scheduler, in degrees
+TRACEPOINT_EVENT(
+  ros2_gremsy,
+  goal_sent,
+  TP_ARGS(
+    const void *, node_handle_arg,
+    double, roll_arg,
+    double, tilt_arg,
+    double, pan_arg
+  ),
+  TP_FIELDS(
+    ctf_integer_hex(const void *, node_handle, node_handle_arg)
+    ctf_float(double, roll, roll_arg)
+    ctf_float(double, tilt, tilt_arg)
+    ctf_float(double, pan, pan_arg)
+  )
+)
+
+#endif  // ROS2_GREMSY__TP_GREMSY_H_
+
+#include <lttng/tracepoint-event.h>
@@ -0,0 +1,16 @@
+#ifndef ROS2_GREMSY__TRACING_HPP_
+#define ROS2_GREMSY__TRACING_HPP_
+
+/**
+ * @brief Emit an LTTng tracepoint of the ros2_gremsy provider, see tp_gremsy.h for the events
+ * The tracepoints are compiled out unless the package is built with -DTRACING=ON,
+ * in which case the arguments are not evaluated either.
+ */
+#ifdef ROS2_GREMSY_TRACING_ENABLED
+#include "ros2_gremsy/tp_gremsy.h"
+#define GREMSY_TRACEPOINT(event, ...) tracepoint(ros2_gremsy, event, __VA_ARGS__)
+#else
+#define GREMSY_TRACEPOINT(event, ...) ((void)0)
+#endif
+
+#endif  // ROS2_GREMSY__TRACING_HPP_
@@ -28,6 +28,8 @@
 #ifndef ROS2_GREMSY__UTILS_HPP_
 #define ROS2_GREMSY__UTILS_HPP_
 
+#include <cmath>
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -121,59 +123,80 @@ inline control_gimbal_axis_input_mode_t convertIntToAxisInputMode(int mode)
       return CTRL_ANGLE_ABSOLUTE_FRAME;
   }
 }
+/**
+ * @brief Quaternion of the X-Y-Z rotation given in degrees
+ * Closed form of AngleAxis(roll, X) * AngleAxis(pitch, Y) * AngleAxis(-yaw, Z),
+ * computing each half-angle sin/cos pair once.
+ * The yaw angle is negated to match with incoming goals.
+ */
+inline void convertXYZtoQuaternion(
+  double roll, double pitch, double yaw,
+  double & w, double & x, double & y, double & z)
+{
+  const double half_roll = 0.5 * DEG_TO_RAD * roll;
+  const double half_pitch = 0.5 * DEG_TO_RAD * pitch;
+  const double half_yaw = -0.5 * DEG_TO_RAD * yaw;
+  const double sr = std::sin(half_roll);
+  const double cr = std::cos(half_roll);
+  const double sp = std::sin(half_pitch);
+  const double cp = std::cos(half_pitch);
+  const double sy = std::sin(half_yaw);
+  const double cy = std::cos(half_yaw);
+
+  w = cr * cp * cy - sr * sp * sy;
+  x = sr * cp * cy + cr * sp * sy;
+  y = cr * sp * cy - sr * cp * sy;
+  z = cr * cp * sy + sr * sp * cy;
+}
+
 inline Eigen::Quaterniond convertXYZtoQuaternion(double roll, double pitch, double yaw)
 {
-  // The yaw angle is negated to match with incoming goals
-  Eigen::Quaterniond quat_abs(
-    Eigen::AngleAxisd(DEG_TO_RAD * roll, Eigen::Vector3d::UnitX()) *
-    Eigen::AngleAxisd(DEG_TO_RAD * pitch, Eigen::Vector3d::UnitY()) *
-    Eigen::AngleAxisd(-DEG_TO_RAD * yaw, Eigen::Vector3d::UnitZ()));
+  Eigen::Quaterniond quat_abs;
+  convertXYZtoQuaternion(roll, pitch, yaw, quat_abs.w(), quat_abs.x(), quat_abs.y(), quat_abs.z());
   return quat_abs;
 }
 
-inline Eigen::Vector3d convertQuaterniontoZYX(double x, double y, double z, double w)
+/// Same as convertXYZtoQuaternion, writing straight into a ROS message without tf2::toMsg
+inline void convertXYZtoQuaternion(
+  double roll, double pitch, double yaw, geometry_msgs::msg::Quaternion & quat)
 {
-  Eigen::Vector3d result;
-
-  double sinr_cosp = 2.0 * (w * x + y * z);
-  double cosr_cosp = 1.0 - 2.0 * (x * x + y * y);
-  result[0] = atan2(sinr_cosp, cosr_cosp);
+  convertXYZtoQuaternion(roll, pitch, yaw, quat.w, quat.x, quat.y, quat.z);
+}
 
-  double sinp = 2.0 * (w * y - z * x);
-  if (abs(sinp) >= 1) {
-    result[1] = copysign(M_PI / 2, sinp);
-  } else {
-    result[1] = asin(sinp);
+/**
+ * @brief Batch version of convertXYZtoQuaternion over arrays of n samples
+ * The loop has no dependencies between samples, so that the compiler can vectorize it
+ * where a vector math library is available.
+ */
+inline void convertXYZtoQuaternion(
+  const double * roll, const double * pitch, const double * yaw, std::size_t n,
+  double * w, double * x, double * y, double * z)
+{
+  for (std::size_t i = 0; i < n; ++i) {
+    convertXYZtoQuaternion(roll[i], pitch[i], yaw[i], w[i], x[i], y[i], z[i]);
   }
-
-  double siny_cosp = 2.0 * (w * z + x * y);
-  double cosy_cosp = 1.0 - 2.0 * (y * y + z * z);
-  result[2] = atan2(siny_cosp, cosy_cosp);
-
-  return result;
 }
 
-inline sensor_msgs::msg::Imu convertImuMavlinkMessageToROSMessage(mavlink_raw_imu_t message)
+inline Eigen::Vector3d convertQuaterniontoZYX(double x, double y, double z, double w)
 {
-  sensor_msgs::msg::Imu imu_message;
+  Eigen::Vector3d result;
 
-  // Set accelaration data
-  imu_message.linear_acceleration.x = message.xacc;
-  imu_message.linear_acceleration.y = message.yacc;
-  imu_message.linear_acceleration.z = message.zacc;
+  const double xx = x * x;
+  const double yy = y * y;
+  const double zz = z * z;
 
-  // Set gyro data
-  imu_message.angular_velocity.x = message.xgyro;
-  imu_message.angular_velocity.y = message.ygyro;
-  imu_message.angular_velocity.z = message.zgyro;
+  result[0] = std::atan2(2.0 * (w * x + y * z), 1.0 - 2.0 * (xx + yy));
+  // Clamping saturates the pitch to +-90 degrees at the gimbal lock
+  result[1] = std::asin(std::fmin(std::fmax(2.0 * (w * y - z * x), -1.0), 1.0));
+  result[2] = std::atan2(2.0 * (w * z + x * y), 1.0 - 2.0 * (yy + zz));
 
-  return imu_message;
+  return result;
 }
 
 inline geometry_msgs::msg::QuaternionStamped stampQuaternion(
-  geometry_msgs::msg::Quaternion quat,
-  std::string frame_id,
-  builtin_interfaces::msg::Time time)
+  const geometry_msgs::msg::Quaternion & quat,
+  const std::string & frame_id,
+  const builtin_interfaces::msg::Time & time)
 {
   geometry_msgs::msg::QuaternionStamped quat_stamped;
   quat_stamped.header.frame_id = frame_id;
@@ -182,6 +205,16 @@ inline geometry_msgs::msg::QuaternionStamped stampQuaternion(
   return quat_stamped;
 }
 
+/// Same as stampQuaternion, into an existing message whose frame_id is already set
+inline void stampQuaternion(
+  const geometry_msgs::msg::Quaternion & quat,
+  const builtin_interfaces::msg::Time & time,
+  geometry_msgs::msg::QuaternionStamped & quat_stamped)
+{
+  quat_stamped.header.stamp = time;
+  quat_stamped.quaternion = quat;
+}
+
 inline double limitAngle(double angle, double min, double max)
 {
   if (angle > max) {
@@ -197,6 +230,16 @@ inline double limitAngle(double angle, double range)
   return limitAngle(angle, -range, range);
 }
 
+/// Wrap an angle in degrees to the range [-180, 180)
+inline double wrapAngle(double angle)
+{
+  angle = std::fmod(angle + 180.0, 360.0);
+  if (angle < 0.0) {
+    angle += 360.0;
+  }
+  return angle - 180.0;
+}
+
 
 }  // namespace ros2_gremsy
 
@@ -0,0 +1,63 @@
+#include <cmath>
+
+#include "ros2_gremsy/attitude_filter.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Gyro samples further apart than this are not integrated, e.g. after a link outage
+constexpr double kMaxSampleInterval = 0.5;
+}  // namespace
+
+void AttitudeFilter::configure(const Config & config)
+{
+  config_ = config;
+}
+
+bool AttitudeFilter::predict(const Eigen::Vector3d & gyro, uint64_t time_usec)
+{
+  if (time_usec == last_gyro_usec_) {
+    return false;
+  }
+  const double dt = last_gyro_usec_ == 0 || time_usec < last_gyro_usec_ ?
+    0.0 : 1e-6 * static_cast<double>(time_usec - last_gyro_usec_);
+  last_gyro_usec_ = time_usec;
+  if (!initialized_) {
+    return false;
+  }
+  if (dt <= 0.0 || dt > kMaxSampleInterval) {
+    return true;
+  }
+
+  // Body rates rotate the orientation on the right
+  const Eigen::Vector3d rotation = dt * config_.gyro_signs.cwiseProduct(gyro);
+  const double angle = rotation.norm();
+  if (angle > 0.0) {
+    orientation_ = orientation_ * Eigen::Quaterniond(Eigen::AngleAxisd(angle, rotation / angle));
+    orientation_.normalize();
+  }
+  return true;
+}
+
+void AttitudeFilter::correct(const Eigen::Quaterniond & orientation, uint64_t time_usec)
+{
+  if (time_usec == last_correction_usec_) {
+    return;
+  }
+  const double dt = last_correction_usec_ == 0 || time_usec < last_correction_usec_ ?
+    0.0 : 1e-6 * static_cast<double>(time_usec - last_correction_usec_);
+  last_correction_usec_ = time_usec;
+
+  if (!initialized_ || config_.time_constant <= 0.0) {
+    orientation_ = orientation.normalized();
+    initialized_ = true;
+    return;
+  }
+  const double gain = dt / (config_.time_constant + dt);
+  orientation_ = orientation_.slerp(gain, orientation.normalized());
+  orientation_.normalize();
+}
+
+}  // namespace ros2_gremsy
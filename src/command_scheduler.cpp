@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "ros2_gremsy/command_scheduler.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// The gimbal interface has no notification for new messages, so the ACK is polled
+constexpr std::chrono::milliseconds kAckPollPeriod(1);
+}  // namespace
+
+CommandScheduler::CommandScheduler(
+  const Config & config, SetpointFunction send_setpoint, AckFunction read_ack)
+: config_(config), send_setpoint_(std::move(send_setpoint)), read_ack_(std::move(read_ack))
+{
+}
+
+CommandScheduler::~CommandScheduler()
+{
+  stop();
+}
+
+void CommandScheduler::start()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  worker_ = std::thread(&CommandScheduler::run, this);
+}
+
+void CommandScheduler::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Command & command : commands_) {
+    command.result.set_value(false);
+  }
+  commands_.clear();
+}
+
+std::shared_future<bool> CommandScheduler::submitCommand(
+  const std::string & name, uint16_t command_id, CommandFunction send)
+{
+  Command command{name, command_id, std::move(send), std::promise<bool>()};
+  std::shared_future<bool> result = command.result.get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    commands_.push_back(std::move(command));
+  }
+  cv_.notify_one();
+  return result;
+}
+
+void CommandScheduler::submitSetpoint(const Eigen::Vector3d & setpoint)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setpoint_ = setpoint;
+    has_setpoint_ = true;
+  }
+  cv_.notify_one();
+}
+
+CommandScheduler::Stats CommandScheduler::stats() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+std::string CommandScheduler::lastFailedCommand() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_failed_command_;
+}
+
+void CommandScheduler::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    cv_.wait(lock, [this] {return !running_ || !commands_.empty() || has_setpoint_;});
+    if (!running_) {
+      break;
+    }
+
+    // Configuration commands preempt the motion setpoints
+    if (!commands_.empty()) {
+      Command command = std::move(commands_.front());
+      commands_.pop_front();
+      const bool acked = execute(command, lock);
+      command.result.set_value(acked);
+      continue;
+    }
+
+    const Eigen::Vector3d setpoint = setpoint_;
+    has_setpoint_ = false;
+    ++stats_.setpoints;
+    lock.unlock();
+    send_setpoint_(setpoint);
+    lock.lock();
+  }
+}
+
+bool CommandScheduler::execute(Command & command, std::unique_lock<std::mutex> & lock)
+{
+  ++stats_.commands;
+  std::optional<uint8_t> result;
+  for (int attempt = 0; attempt <= config_.max_retries && running_; ++attempt) {
+    if (attempt > 0) {
+      ++stats_.retries;
+    }
+    lock.unlock();
+    const uint64_t previous_stamp = read_ack_().stamp;
+    const Clock::time_point sent = Clock::now();
+    command.send();
+    result = waitForAck(
+      command.command, previous_stamp,
+      sent + std::chrono::duration_cast<Clock::duration>(config_.ack_timeout));
+    const double rtt_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - sent).count();
+    lock.lock();
+
+    if (result == MAV_RESULT_ACCEPTED) {
+      ++stats_.acked;
+      stats_.last_rtt_ms = rtt_ms;
+      stats_.max_rtt_ms = std::max(stats_.max_rtt_ms, rtt_ms);
+      stats_.mean_rtt_ms += (rtt_ms - stats_.mean_rtt_ms) / static_cast<double>(stats_.acked);
+      return true;
+    }
+    // Denied, unsupported or failed commands would get the same answer again
+    if (result && *result != MAV_RESULT_TEMPORARILY_REJECTED) {
+      break;
+    }
+  }
+  ++stats_.failed;
+  if (result) {
+    ++stats_.rejected;
+    last_failed_command_ = command.name + " rejected with MAV_RESULT " + std::to_string(*result);
+  } else {
+    last_failed_command_ = command.name + " not acknowledged";
+  }
+  return false;
+}
+
+std::optional<uint8_t> CommandScheduler::waitForAck(
+  uint16_t command, uint64_t previous_stamp, Clock::time_point deadline)
+{
+  uint64_t stamp = previous_stamp;
+  while (Clock::now() < deadline) {
+    std::this_thread::sleep_for(kAckPollPeriod);
+    const Ack ack = read_ack_();
+    if (ack.stamp == stamp) {
+      continue;
+    }
+    stamp = ack.stamp;
+    // Only one configuration command is in flight, but late ACKs of earlier commands or of
+    // the setpoints can still arrive
+    if (ack.command == command) {
+      return ack.result;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace ros2_gremsy
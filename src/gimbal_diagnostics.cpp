@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cinttypes>
+
+#include "ros2_gremsy/gimbal_diagnostics.hpp"
+#include "ros2_gremsy/serial_link.hpp"
+
+namespace ros2_gremsy
+{
+
+using diagnostic_msgs::msg::DiagnosticStatus;
+
+GimbalDiagnostics::GimbalDiagnostics(
+  rclcpp::Node * node, const Config & config, const Sources & sources)
+: config_(config), sources_(sources),
+  state_min_rate_(config.state_rate), state_max_rate_(config.state_rate),
+  goal_min_rate_(config.goal_rate), goal_max_rate_(config.goal_rate),
+  state_frequency_(
+    diagnostic_updater::FrequencyStatusParam(
+      &state_min_rate_, &state_max_rate_, config.rate_tolerance), "State rate"),
+  goal_frequency_(
+    diagnostic_updater::FrequencyStatusParam(
+      &goal_min_rate_, &goal_max_rate_, config.rate_tolerance), "Goal rate"),
+  last_link_update_(Clock::now()),
+  updater_(node)
+{
+  updater_.setHardwareID(config_.hardware_id);
+  updater_.add(state_frequency_);
+  updater_.add(goal_frequency_);
+  updater_.add("Link", this, &GimbalDiagnostics::linkStatus);
+  updater_.add("Gimbal", this, &GimbalDiagnostics::gimbalStatus);
+  updater_.add("Goal ticks", this, &GimbalDiagnostics::goalStatus);
+  if (sources_.qos_events) {
+    updater_.add("Topic QoS", this, &GimbalDiagnostics::qosStatus);
+  }
+}
+
+void GimbalDiagnostics::countUpdate(uint64_t stamp, uint64_t & last_stamp, uint64_t & count)
+{
+  if (stamp != 0 && stamp != last_stamp) {
+    ++count;
+  }
+}
+
+void GimbalDiagnostics::stateTick(const GimbalState & state)
+{
+  state_frequency_.tick();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  countUpdate(state.raw_imu.time_usec, last_state_.raw_imu.time_usec, imu_count_);
+  countUpdate(
+    state.mount_status_time_usec, last_state_.mount_status_time_usec, mount_status_count_);
+  countUpdate(
+    state.mount_orientation_time_usec, last_state_.mount_orientation_time_usec,
+    mount_orientation_count_);
+  countUpdate(state.heartbeat_time_usec, last_state_.heartbeat_time_usec, heartbeat_count_);
+
+  if (state.raw_imu.time_usec != 0 && state.raw_imu.time_usec != last_state_.raw_imu.time_usec) {
+    time_offset_usec_ = static_cast<int64_t>(state.raw_imu.time_usec) -
+      static_cast<int64_t>(state.raw_imu_device_time_usec);
+    if (!time_offset_valid_) {
+      min_time_offset_usec_ = max_time_offset_usec_ = time_offset_usec_;
+      time_offset_valid_ = true;
+    }
+    min_time_offset_usec_ = std::min(min_time_offset_usec_, time_offset_usec_);
+    max_time_offset_usec_ = std::max(max_time_offset_usec_, time_offset_usec_);
+  }
+  last_state_ = state;
+}
+
+void GimbalDiagnostics::setStateRate(double rate)
+{
+  // The frequency status reads the expected rates through pointers at each update
+  state_min_rate_ = rate;
+  state_max_rate_ = rate;
+  std::lock_guard<std::mutex> lock(mutex_);
+  config_.state_rate = rate;
+}
+
+void GimbalDiagnostics::setGoalRate(double rate)
+{
+  goal_min_rate_ = rate;
+  goal_max_rate_ = rate;
+  std::lock_guard<std::mutex> lock(mutex_);
+  config_.goal_rate = rate;
+}
+
+void GimbalDiagnostics::goalTick()
+{
+  goal_frequency_.tick();
+
+  const Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (last_goal_tick_ != Clock::time_point()) {
+    const double interval = std::chrono::duration<double>(now - last_goal_tick_).count();
+    max_goal_interval_ = std::max(max_goal_interval_, interval);
+    if (interval > (1.0 + config_.rate_tolerance) / config_.goal_rate) {
+      ++late_goal_ticks_;
+      ++total_late_goal_ticks_;
+    }
+  }
+  ++goal_ticks_;
+  last_goal_tick_ = now;
+}
+
+void GimbalDiagnostics::linkStatus(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  const CommandScheduler::Stats commands = sources_.command_stats ?
+    sources_.command_stats() : CommandScheduler::Stats();
+  const StreamRateController::Rates requested_rates = sources_.stream_rates ?
+    sources_.stream_rates() : StreamRateController::Rates{-1.0, -1.0, -1.0};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Clock::time_point now = Clock::now();
+  const double period = std::chrono::duration<double>(now - last_link_update_).count();
+  last_link_update_ = now;
+  const auto rate = [period](uint64_t count, uint64_t & last_count) {
+      const double result = period > 0.0 ? (count - last_count) / period : 0.0;
+      last_count = count;
+      return result;
+    };
+
+  // Heartbeat age against the receive stamps, which are on the host clock
+  const uint64_t now_usec = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+  const bool heartbeat_received = last_state_.heartbeat_time_usec != 0;
+  const double heartbeat_age = heartbeat_received ?
+    1e-6 * static_cast<double>(static_cast<int64_t>(now_usec - last_state_.heartbeat_time_usec)) :
+    0.0;
+
+  if (!heartbeat_received) {
+    stat.summary(DiagnosticStatus::ERROR, "No heartbeat received");
+  } else if (heartbeat_age >= config_.heartbeat_error_age) {
+    stat.summaryf(DiagnosticStatus::ERROR, "Heartbeat lost for %.1f s", heartbeat_age);
+  } else if (heartbeat_age >= config_.heartbeat_warn_age) {
+    stat.summaryf(DiagnosticStatus::WARN, "Heartbeat late by %.1f s", heartbeat_age);
+  } else {
+    stat.summary(DiagnosticStatus::OK, "Link OK");
+  }
+  const std::string link_tap_error = sources_.link_tap_error ?
+    sources_.link_tap_error() : std::string();
+  if (!link_tap_error.empty()) {
+    stat.mergeSummary(DiagnosticStatus::ERROR, "Link tap stopped: " + link_tap_error);
+  }
+  if (commands.failed > commands.rejected) {
+    stat.mergeSummaryf(
+      DiagnosticStatus::WARN, "%" PRIu64 " commands not acknowledged",
+      commands.failed - commands.rejected);
+  }
+  if (commands.rejected > 0) {
+    stat.mergeSummaryf(
+      DiagnosticStatus::WARN, "%" PRIu64 " commands rejected", commands.rejected);
+  }
+
+  const double heartbeat_rate = rate(heartbeat_count_, last_heartbeat_count_);
+  const double imu_rate = rate(imu_count_, last_imu_count_);
+  const double mount_status_rate = rate(mount_status_count_, last_mount_status_count_);
+  const double mount_orientation_rate =
+    rate(mount_orientation_count_, last_mount_orientation_count_);
+  const double setpoint_rate = rate(commands.setpoints, last_setpoints_);
+  const double command_rate = rate(commands.commands + commands.retries, last_commands_);
+
+  // Measured by the link tap if there is one, otherwise estimated from the message rates
+  // with full MAVLink 2 frames. The estimate leaves out the messages the driver does not use.
+  const bool measured = sources_.rx_bytes && sources_.tx_bytes;
+  double rx_bytes_rate;
+  double tx_bytes_rate;
+  if (measured) {
+    rx_bytes_rate = rate(sources_.rx_bytes(), last_rx_bytes_);
+    tx_bytes_rate = rate(sources_.tx_bytes(), last_tx_bytes_);
+  } else {
+    rx_bytes_rate =
+      heartbeat_rate * (MAVLINK_MSG_ID_HEARTBEAT_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES) +
+      imu_rate * (MAVLINK_MSG_ID_RAW_IMU_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES) +
+      mount_status_rate * (MAVLINK_MSG_ID_MOUNT_STATUS_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES) +
+      mount_orientation_rate *
+      (MAVLINK_MSG_ID_MOUNT_ORIENTATION_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+    tx_bytes_rate = (setpoint_rate + command_rate) *
+      (MAVLINK_MSG_ID_COMMAND_LONG_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+  }
+  const double link_capacity = linkBytesPerSecond(config_.baudrate);
+  const double rx_utilization = rx_bytes_rate / link_capacity;
+  const double tx_utilization = tx_bytes_rate / link_capacity;
+  if (std::max(rx_utilization, tx_utilization) >= config_.max_link_utilization) {
+    stat.mergeSummaryf(
+      DiagnosticStatus::WARN, "Link utilization %.0f %% at %d baud",
+      100.0 * std::max(rx_utilization, tx_utilization), config_.baudrate);
+  }
+
+  // Confirm the requested stream rates, a stream may also run faster than requested
+  const StreamRateController::Rates measured_rates = {imu_rate, mount_status_rate,
+    mount_orientation_rate};
+  for (int i = 0; i < StreamRateController::NUM_STREAMS; ++i) {
+    if (requested_rates[i] > 0.0 &&
+      measured_rates[i] < (1.0 - config_.rate_tolerance) * requested_rates[i])
+    {
+      stat.mergeSummaryf(
+        DiagnosticStatus::WARN, "%s stream at %.1f Hz instead of %.1f Hz",
+        StreamRateController::name(static_cast<StreamRateController::Stream>(i)),
+        measured_rates[i], requested_rates[i]);
+    }
+  }
+
+  stat.addf("Heartbeat age [s]", "%.3f", heartbeat_age);
+  stat.addf("RX heartbeat rate [Hz]", "%.1f", heartbeat_rate);
+  stat.addf("RX raw IMU rate [Hz]", "%.1f", imu_rate);
+  stat.addf("RX mount status rate [Hz]", "%.1f", mount_status_rate);
+  stat.addf("RX mount orientation rate [Hz]", "%.1f", mount_orientation_rate);
+  if (sources_.stream_rates) {
+    stat.addf(
+      "RX raw IMU requested rate [Hz]", "%.1f", requested_rates[StreamRateController::RAW_IMU]);
+    stat.addf(
+      "RX mount status requested rate [Hz]", "%.1f",
+      requested_rates[StreamRateController::MOUNT_STATUS]);
+    stat.addf(
+      "RX mount orientation requested rate [Hz]", "%.1f",
+      requested_rates[StreamRateController::MOUNT_ORIENTATION]);
+  }
+  stat.addf("State poll rate [Hz]", "%.1f", config_.state_rate);
+  stat.add("Baudrate", config_.baudrate);
+  stat.add("Link utilization", measured ? "measured" : "estimated");
+  stat.addf("RX bytes rate [B/s]", "%.0f", rx_bytes_rate);
+  stat.addf("TX bytes rate [B/s]", "%.0f", tx_bytes_rate);
+  stat.addf("RX link utilization [%]", "%.1f", 100.0 * rx_utilization);
+  stat.addf("TX link utilization [%]", "%.1f", 100.0 * tx_utilization);
+  stat.addf("TX setpoint rate [Hz]", "%.1f", setpoint_rate);
+  stat.add("TX commands", commands.commands);
+  stat.add("TX command retries", commands.retries);
+  stat.add("TX commands not acknowledged", commands.failed - commands.rejected);
+  stat.add("TX commands rejected", commands.rejected);
+  stat.addf("Command ACK round-trip mean [ms]", "%.1f", commands.mean_rtt_ms);
+  stat.addf("Command ACK round-trip max [ms]", "%.1f", commands.max_rtt_ms);
+}
+
+void GimbalDiagnostics::gimbalStatus(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  const int mode = sources_.gimbal_mode ? sources_.gimbal_mode() : GIMBAL_STATE_OFF;
+  const bool motors_on = mode >= GIMBAL_STATE_ON;
+  if (motors_on) {
+    stat.summary(DiagnosticStatus::OK, "Motors on");
+  } else {
+    stat.summary(DiagnosticStatus::WARN, "Motors off");
+  }
+  stat.add("Gimbal mode", mode);
+  stat.add("Motors", motors_on ? "on" : "off");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!time_offset_valid_) {
+    stat.add("Time offset [s]", "unknown");
+    return;
+  }
+  const double jitter = 1e-6 * static_cast<double>(max_time_offset_usec_ - min_time_offset_usec_);
+  stat.addf("Time offset [s]", "%.6f", 1e-6 * static_cast<double>(time_offset_usec_));
+  stat.addf("Time offset jitter [s]", "%.6f", jitter);
+  if (jitter > config_.time_offset_jitter_warn) {
+    stat.mergeSummaryf(DiagnosticStatus::WARN, "Time offset jitter of %.3f s", jitter);
+  }
+  // The jitter is measured over one update period
+  min_time_offset_usec_ = max_time_offset_usec_ = time_offset_usec_;
+}
+
+void GimbalDiagnostics::goalStatus(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double late_ratio = goal_ticks_ > 0 ?
+    static_cast<double>(late_goal_ticks_) / static_cast<double>(goal_ticks_) : 0.0;
+  if (late_ratio > config_.max_late_goal_ratio) {
+    stat.summaryf(
+      DiagnosticStatus::WARN, "%.1f %% of the goal ticks started late", 100.0 * late_ratio);
+  } else {
+    stat.summary(DiagnosticStatus::OK, "Goal ticks on time");
+  }
+  stat.add("Goal ticks", goal_ticks_);
+  stat.add("Late goal ticks", late_goal_ticks_);
+  stat.add("Late goal ticks total", total_late_goal_ticks_);
+  stat.addf("Max goal tick interval [ms]", "%.1f", 1e3 * max_goal_interval_);
+  goal_ticks_ = 0;
+  late_goal_ticks_ = 0;
+  max_goal_interval_ = 0.0;
+}
+
+void GimbalDiagnostics::qosStatus(diagnostic_updater::DiagnosticStatusWrapper & stat)
+{
+  const QosEvents::Counts events = sources_.qos_events();
+  const uint64_t deadlines_missed = events.deadlines_missed - last_qos_events_.deadlines_missed;
+  const uint64_t liveliness_lost = events.liveliness_lost - last_qos_events_.liveliness_lost;
+  const uint64_t incompatible_qos = events.incompatible_qos - last_qos_events_.incompatible_qos;
+  stat.summary(DiagnosticStatus::OK, "No QoS events");
+  if (incompatible_qos > 0) {
+    stat.mergeSummaryf(DiagnosticStatus::WARN, "%" PRIu64 " endpoints with incompatible QoS",
+      incompatible_qos);
+  }
+  if (deadlines_missed > 0) {
+    stat.mergeSummaryf(DiagnosticStatus::WARN, "%" PRIu64 " deadlines missed", deadlines_missed);
+  }
+  if (liveliness_lost > 0) {
+    stat.mergeSummaryf(DiagnosticStatus::WARN, "%" PRIu64 " liveliness lost", liveliness_lost);
+  }
+  stat.add("Deadlines missed", events.deadlines_missed);
+  stat.add("Liveliness lost", events.liveliness_lost);
+  stat.add("Incompatible QoS", events.incompatible_qos);
+  stat.add("Last event topic", events.last_topic.empty() ? "none" : events.last_topic);
+  last_qos_events_ = events;
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,56 @@
+#include <cstring>
+
+#include "ros2_gremsy/gimbal_state.hpp"
+
+namespace ros2_gremsy
+{
+
+GimbalState readGimbalState(Gimbal_Interface & gimbal, int max_attempts)
+{
+  GimbalState state;
+  auto stamps = gimbal.get_gimbal_time_stamps();
+  for (int attempt = 0; attempt < max_attempts; ++attempt) {
+    state.raw_imu = gimbal.get_gimbal_raw_imu();
+    state.mount_status = gimbal.get_gimbal_mount_status();
+    state.mount_orientation = gimbal.get_gimbal_mount_orientation();
+
+    const auto after = gimbal.get_gimbal_time_stamps();
+    const bool consistent = after.raw_imu == stamps.raw_imu &&
+      after.mount_status == stamps.mount_status &&
+      after.mount_orientation == stamps.mount_orientation;
+    stamps = after;
+    if (consistent) {
+      break;
+    }
+  }
+  state.raw_imu_device_time_usec = state.raw_imu.time_usec;
+  state.raw_imu.time_usec = stamps.raw_imu;
+  state.mount_status_time_usec = stamps.mount_status;
+  state.mount_orientation_time_usec = stamps.mount_orientation;
+  state.heartbeat_time_usec = stamps.heartbeat;
+  state.mode = static_cast<int>(gimbal.get_gimbal_status().mode);
+  return state;
+}
+
+CommandAck readCommandAck(Gimbal_Interface & gimbal, int max_attempts)
+{
+  CommandAck ack;
+  uint64_t stamp = gimbal.get_gimbal_time_stamps().command_ack;
+  for (int attempt = 0; attempt < max_attempts; ++attempt) {
+    // The receive thread may be decoding into the message without a stamp update yet,
+    // so a copy only counts if a second one matches it
+    ack.message = gimbal.current_messages.command_ack;
+    const mavlink_command_ack_t again = gimbal.current_messages.command_ack;
+    const uint64_t after = gimbal.get_gimbal_time_stamps().command_ack;
+    const bool consistent = after == stamp &&
+      std::memcmp(&ack.message, &again, sizeof(again)) == 0;
+    stamp = after;
+    if (consistent) {
+      break;
+    }
+  }
+  ack.time_usec = stamp;
+  return ack;
+}
+
+}  // namespace ros2_gremsy
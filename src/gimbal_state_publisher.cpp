@@ -0,0 +1,225 @@
+#include <algorithm>
+
+#include "ros2_gremsy/gimbal_state_publisher.hpp"
+#include "ros2_gremsy/utils.hpp"
+
+namespace ros2_gremsy
+{
+
+GimbalStatePublisher::GimbalStatePublisher(rclcpp::Node & node, const Config & config)
+: config_(config), clock_(node.get_clock())
+{
+  imu_calibration_.configure(config_.imu);
+  attitude_filter_.configure(config_.attitude);
+
+  // The frame ids are the only strings of the messages, set once here
+  imu_msg_.header.frame_id = config_.frame_id;
+  encoder_msg_.header.frame_id = config_.frame_id;
+  orientation_global_msg_.header.frame_id = config_.frame_id;
+  orientation_local_msg_.header.frame_id = config_.frame_id;
+  orientation_fused_msg_.header.frame_id = config_.frame_id;
+  state_msg_.header.frame_id = config_.frame_id;
+
+  const std::string prefix = node.get_fully_qualified_name();
+  const auto options = [this, &prefix](const char * topic) {
+      return config_.qos_events ?
+             config_.qos_events->publisherOptions(prefix + "/" + topic) :
+             rclcpp::PublisherOptions();
+    };
+  state_pub_ = node.create_publisher<msg::GimbalState>("~/state", config_.qos, options("state"));
+  if (config_.legacy_topics) {
+    imu_pub_ = node.create_publisher<sensor_msgs::msg::Imu>(
+      "~/imu", config_.qos, options("imu"));
+    encoder_pub_ = node.create_publisher<geometry_msgs::msg::Vector3Stamped>(
+      "~/encoder", config_.qos, options("encoder"));
+    mount_orientation_global_pub_ = node.create_publisher<geometry_msgs::msg::QuaternionStamped>(
+      "~/mount_orientation_global", config_.qos, options("mount_orientation_global"));
+    mount_orientation_local_pub_ = node.create_publisher<geometry_msgs::msg::QuaternionStamped>(
+      "~/mount_orientation_local", config_.qos, options("mount_orientation_local"));
+  }
+  if (config_.attitude_filter) {
+    mount_orientation_fused_pub_ = node.create_publisher<geometry_msgs::msg::QuaternionStamped>(
+      "~/mount_orientation_fused", config_.qos, options("mount_orientation_fused"));
+  }
+}
+
+std::array<bool, StreamRateController::NUM_STREAMS> GimbalStatePublisher::consumedStreams() const
+{
+  const auto subscribed = [](const rclcpp::PublisherBase::SharedPtr & publisher) {
+      return publisher && publisher->get_subscription_count() > 0;
+    };
+  // The state carries every stream, the fused orientation needs both the gyro and the
+  // mount orientation
+  const bool all = subscribed(state_pub_);
+  const bool fused = subscribed(mount_orientation_fused_pub_);
+  std::array<bool, StreamRateController::NUM_STREAMS> consumed;
+  consumed[StreamRateController::RAW_IMU] = all || fused || subscribed(imu_pub_);
+  consumed[StreamRateController::MOUNT_STATUS] = all || subscribed(encoder_pub_);
+  consumed[StreamRateController::MOUNT_ORIENTATION] = all || fused ||
+    subscribed(mount_orientation_global_pub_) || subscribed(mount_orientation_local_pub_);
+  return consumed;
+}
+
+rclcpp::Time GimbalStatePublisher::receiveTime(uint64_t time_usec)
+{
+  return rclcpp::Time(static_cast<int64_t>(time_usec * 1000UL));
+}
+
+GimbalStatePublisher::Stamps GimbalStatePublisher::stamps(const GimbalState & state) const
+{
+  if (config_.use_ros_time) {
+    const rclcpp::Time now = clock_->now();
+    return {now, now, now};
+  }
+  return {
+    receiveTime(state.raw_imu.time_usec),
+    receiveTime(state.mount_status_time_usec),
+    receiveTime(state.mount_orientation_time_usec)};
+}
+
+void GimbalStatePublisher::publish(const GimbalState & state)
+{
+  const Stamps time = stamps(state);
+  const mavlink_mount_orientation_t & mount_orientation = state.mount_orientation;
+
+  // One message for the whole state, only when a sample is new
+  if (newSamples(state)) {
+    publishMessage(
+      *state_pub_, state_msg_, [&](msg::GimbalState & msg) {
+        fillState(state, time.imu, msg);
+      });
+  }
+
+  if (config_.legacy_topics) {
+    publishMessage(
+      *imu_pub_, imu_msg_, [&](sensor_msgs::msg::Imu & msg) {
+        fillImu(state.raw_imu, time.imu, msg);
+      });
+    publishMessage(
+      *encoder_pub_, encoder_msg_, [&](geometry_msgs::msg::Vector3Stamped & msg) {
+        fillEncoder(state.mount_status, time.encoder, msg);
+      });
+    // Camera Mount Orientation in global frame (drifting)
+    publishMessage(
+      *mount_orientation_global_pub_, orientation_global_msg_,
+      [&](geometry_msgs::msg::QuaternionStamped & msg) {
+        fillOrientation(mount_orientation, mount_orientation.yaw_absolute, time.orientation, msg);
+      });
+    // Camera Mount Orientation in local frame (yaw relative to vehicle)
+    publishMessage(
+      *mount_orientation_local_pub_, orientation_local_msg_,
+      [&](geometry_msgs::msg::QuaternionStamped & msg) {
+        fillOrientation(mount_orientation, mount_orientation.yaw, time.orientation, msg);
+      });
+  }
+  // Fused orientation in global frame for every new IMU sample
+  if (updateAttitude(state)) {
+    publishMessage(
+      *mount_orientation_fused_pub_, orientation_fused_msg_,
+      [&](geometry_msgs::msg::QuaternionStamped & msg) {
+        msg.header.stamp = time.imu;
+        msg.quaternion = tf2::toMsg(attitude_filter_.orientation());
+      });
+  }
+}
+
+bool GimbalStatePublisher::update(const GimbalState & state)
+{
+  const Stamps time = stamps(state);
+  const mavlink_mount_orientation_t & mount_orientation = state.mount_orientation;
+  fillImu(state.raw_imu, time.imu, imu_msg_);
+  fillEncoder(state.mount_status, time.encoder, encoder_msg_);
+  fillOrientation(
+    mount_orientation, mount_orientation.yaw_absolute, time.orientation, orientation_global_msg_);
+  fillOrientation(mount_orientation, mount_orientation.yaw, time.orientation, orientation_local_msg_);
+  fillState(state, time.imu, state_msg_);
+  if (!updateAttitude(state)) {
+    return false;
+  }
+  orientation_fused_msg_.header.stamp = time.imu;
+  orientation_fused_msg_.quaternion = tf2::toMsg(attitude_filter_.orientation());
+  return true;
+}
+
+void GimbalStatePublisher::fillImu(
+  const mavlink_raw_imu_t & imu_mav, const rclcpp::Time & time, sensor_msgs::msg::Imu & msg)
+{
+  imu_calibration_.apply(imu_mav, msg);
+  msg.header.stamp = time;
+}
+
+void GimbalStatePublisher::fillEncoder(
+  const mavlink_mount_status_t & mount_status, const rclcpp::Time & time,
+  geometry_msgs::msg::Vector3Stamped & msg)
+{
+  msg.header.stamp = time;
+  msg.vector.x = ((float) mount_status.pointing_b) * DEG_TO_RAD;
+  msg.vector.y = ((float) mount_status.pointing_a) * DEG_TO_RAD;
+  msg.vector.z = ((float) mount_status.pointing_c) * DEG_TO_RAD;
+}
+
+void GimbalStatePublisher::fillOrientation(
+  const mavlink_mount_orientation_t & mount_orientation, double yaw, const rclcpp::Time & time,
+  geometry_msgs::msg::QuaternionStamped & msg)
+{
+  msg.header.stamp = time;
+  convertXYZtoQuaternion(mount_orientation.roll, mount_orientation.pitch, yaw, msg.quaternion);
+}
+
+void GimbalStatePublisher::fillState(
+  const GimbalState & state, const rclcpp::Time & time, msg::GimbalState & msg)
+{
+  // All three are receive stamps of the same clock, so without the node time the poll
+  // is stamped with the newest of them
+  const uint64_t newest_usec = std::max(
+    {state.raw_imu.time_usec, state.mount_status_time_usec, state.mount_orientation_time_usec});
+  msg.header.stamp = config_.use_ros_time ? time : receiveTime(newest_usec);
+  msg.imu_stamp = receiveTime(state.raw_imu.time_usec);
+  msg.encoder_stamp = receiveTime(state.mount_status_time_usec);
+  msg.orientation_stamp = receiveTime(state.mount_orientation_time_usec);
+
+  // The calibration only updates its estimates with new samples, filling twice is harmless
+  imu_calibration_.apply(state.raw_imu, imu_msg_);
+  msg.linear_acceleration = imu_msg_.linear_acceleration;
+  msg.angular_velocity = imu_msg_.angular_velocity;
+
+  const mavlink_mount_status_t & mount_status = state.mount_status;
+  msg.encoder.x = ((float) mount_status.pointing_b) * DEG_TO_RAD;
+  msg.encoder.y = ((float) mount_status.pointing_a) * DEG_TO_RAD;
+  msg.encoder.z = ((float) mount_status.pointing_c) * DEG_TO_RAD;
+
+  const mavlink_mount_orientation_t & mount_orientation = state.mount_orientation;
+  convertXYZtoQuaternion(
+    mount_orientation.roll, mount_orientation.pitch, mount_orientation.yaw_absolute,
+    msg.orientation_global);
+  convertXYZtoQuaternion(
+    mount_orientation.roll, mount_orientation.pitch, mount_orientation.yaw, msg.orientation_local);
+  msg.mode = static_cast<uint8_t>(state.mode);
+}
+
+bool GimbalStatePublisher::newSamples(const GimbalState & state)
+{
+  const std::array<uint64_t, 3> stamps = {
+    state.raw_imu.time_usec, state.mount_status_time_usec, state.mount_orientation_time_usec};
+  if (stamps == last_stamps_) {
+    return false;
+  }
+  last_stamps_ = stamps;
+  return true;
+}
+
+bool GimbalStatePublisher::updateAttitude(const GimbalState & state)
+{
+  if (!config_.attitude_filter) {
+    return false;
+  }
+  const mavlink_mount_orientation_t & mount_orientation = state.mount_orientation;
+  attitude_filter_.correct(
+    convertXYZtoQuaternion(
+      mount_orientation.roll, mount_orientation.pitch, mount_orientation.yaw_absolute),
+    state.mount_orientation_time_usec);
+  return attitude_filter_.predict(
+    imu_calibration_.angularVelocity(state.raw_imu), state.raw_imu.time_usec);
+}
+
+}  // namespace ros2_gremsy
@@ -1,17 +1,33 @@
+#include <cinttypes>
 #include <cstdio>
 #include <chrono>
 #include <memory>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "ros2_gremsy/gremsy.hpp"
+#include "ros2_gremsy/tracing.hpp"
 
 namespace ros2_gremsy
 {
 using namespace std::chrono_literals;
 using std::placeholders::_1;
 using std::placeholders::_2;
+
+namespace
+{
+/// Descriptor of a parameter only read at startup, setting it at runtime is rejected
+rcl_interfaces::msg::ParameterDescriptor readOnly(rcl_interfaces::msg::ParameterDescriptor descriptor)
+{
+  descriptor.read_only = true;
+  return descriptor;
+}
+}  // namespace
+
 GremsyDriver::GremsyDriver(const rclcpp::NodeOptions & options)
 : Node("ros2_gremsy", options), com_port_("/dev/ttyUSB0"), use_ros_time_(true)
 {
@@ -21,9 +37,16 @@ GremsyDriver::GremsyDriver(const rclcpp::NodeOptions & options)
 GremsyDriver::GremsyDriver(const rclcpp::NodeOptions & options, const std::string & com_port)
 : Node("ros2_gremsy", options), use_ros_time_(true)
 {
+  // Same handle as the rclcpp tracepoints use for the node
+  trace_handle_ = this->get_node_base_interface()->get_rcl_node_handle();
 
   declareParameters();
+  const ParameterLookup parameter = [this](const std::string & name) {
+      return this->get_parameter(name);
+    };
   device_id_ = gremsy_model_t(this->get_parameter("device_id").as_int());
+  device_profile_ = getDeviceProfile(device_id_);
+  prepare_gimbal_move_ = getPrepareGimbalMove(device_id_);
   com_port_ = this->get_parameter("com_port").as_string();
   baud_rate_ = this->get_parameter("baudrate").as_int();
   state_poll_rate_ = this->get_parameter("state_poll_rate").as_double();
@@ -36,164 +59,649 @@ GremsyDriver::GremsyDriver(const rclcpp::NodeOptions & options, const std::strin
   pan_axis_input_mode_ = this->get_parameter("pan_axis_input_mode").as_int();
   pan_axis_stabilize_ = this->get_parameter("pan_axis_stabilize").as_bool();
   lock_yaw_to_vehicle_ = this->get_parameter("lock_yaw_to_vehicle").as_bool();
+  adaptive_poll_rate_ = this->get_parameter("adaptive_poll_rate").as_bool();
+
+  // The gimbal answers an unsupported mode with a rejected ACK, counted in the diagnostics
+  if (const char * axis = undocumentedAxisInputMode(parameter)) {
+    RCLCPP_WARN(this->get_logger(),
+      "Gremsy %s is not documented to support the %s_axis_input_mode, it may be rejected",
+      device_profile_.name, axis);
+  }
+  setpoint_shaping_ = this->get_parameter("setpoint_shaping").as_bool();
+  continuous_yaw_ = this->get_parameter("continuous_yaw").as_bool();
+
+  // IMU calibration, zero scales use the model defaults
+  GimbalStatePublisher::Config state_config;
+  state_config.use_ros_time = use_ros_time_;
+  state_config.legacy_topics = this->get_parameter("legacy_state_topics").as_bool();
+  ImuCalibration::Config & imu_config = state_config.imu;
+  imu_config.accel_scale = this->get_parameter("imu_accel_scale").as_double();
+  imu_config.gyro_scale = this->get_parameter("imu_gyro_scale").as_double();
+  if (imu_config.accel_scale <= 0.0 || imu_config.gyro_scale <= 0.0) {
+    RCLCPP_WARN(this->get_logger(),
+      "Using the assumed raw IMU scales of the %s, set imu_accel_scale and imu_gyro_scale "
+      "once they are measured", device_profile_.name);
+  }
+  if (imu_config.accel_scale <= 0.0) {
+    imu_config.accel_scale = device_profile_.accel_scale;
+  }
+  if (imu_config.gyro_scale <= 0.0) {
+    imu_config.gyro_scale = device_profile_.gyro_scale;
+  }
+  imu_config.accel_stddev = this->get_parameter("imu_accel_stddev").as_double();
+  imu_config.gyro_stddev = this->get_parameter("imu_gyro_stddev").as_double();
+  imu_config.estimate_gyro_bias = this->get_parameter("imu_gyro_bias_estimation").as_bool();
+  imu_config.stationary_gyro_threshold =
+    this->get_parameter("imu_stationary_gyro_threshold").as_double();
+  imu_config.stationary_accel_threshold =
+    this->get_parameter("imu_stationary_accel_threshold").as_double();
+  imu_config.stationary_time = this->get_parameter("imu_stationary_time").as_double();
+  imu_config.bias_time_constant = this->get_parameter("imu_gyro_bias_time_constant").as_double();
+  imu_config.max_gyro_bias = this->get_parameter("imu_max_gyro_bias").as_double();
 
-  // Initialize publishers
-  this->imu_pub_ = this->create_publisher<sensor_msgs::msg::Imu>("~/imu", 10);
-  this->encoder_pub_ = this->create_publisher<geometry_msgs::msg::Vector3Stamped>("~/encoder", 10);
-  this->mount_orientation_global_pub_ =
-    this->create_publisher<geometry_msgs::msg::QuaternionStamped>(
-    "~/mount_orientation_global",
-    10);
-  this->mount_orientation_local_pub_ =
-    this->create_publisher<geometry_msgs::msg::QuaternionStamped>(
-    "~/mount_orientation_local",
-    10);
+  // Attitude filter
+  state_config.attitude_filter = this->get_parameter("attitude_filter").as_bool();
+  AttitudeFilter::Config & attitude_config = state_config.attitude;
+  attitude_config.time_constant = this->get_parameter("attitude_filter_time_constant").as_double();
+  std::vector<double> gyro_signs =
+    this->get_parameter("attitude_filter_gyro_signs").as_double_array();
+  gyro_signs.resize(3, 1.0);
+  attitude_config.gyro_signs = Eigen::Vector3d(gyro_signs[0], gyro_signs[1], gyro_signs[2]);
+
+  // Setpoint shaper limits
+  SetpointShaper::Limits limits;
+  if (!readShaperLimits(parameter, limits)) {
+    RCLCPP_ERROR(this->get_logger(), "Setpoint shaper limits need 3 values (roll, tilt, pan), "
+      "disabling setpoint shaping");
+    setpoint_shaping_ = false;
+  } else if (!SetpointShaper::validLimits(limits, 1.0 / goal_push_rate_)) {
+    RCLCPP_ERROR(this->get_logger(), "Setpoint shaper limits cannot be followed at the "
+      "goal_push_rate, one tick of jerk exceeds the acceleration or velocity limit, "
+      "disabling setpoint shaping");
+    setpoint_shaping_ = false;
+  } else {
+    shaper_.setLimits(limits);
+  }
+
+  // Setpoint deadband and keepalive
+  SetpointFilter::Config filter_config;
+  if (!readFilterConfig(parameter, filter_config)) {
+    RCLCPP_ERROR(this->get_logger(), "goal_deadband needs 3 values (roll, tilt, pan), "
+      "disabling the deadband");
+  }
+  setpoint_filter_.configure(filter_config);
+
+  // Initialize publishers, with the QoS overridable per topic by the qos_overrides parameters
+  qos_events_ = std::make_unique<QosEvents>(this->get_logger());
+  state_config.qos_events = qos_events_.get();
+  state_publisher_ = std::make_unique<GimbalStatePublisher>(*this, state_config);
 
   // Initialize subscribers
+  const std::string topic_prefix = this->get_fully_qualified_name();
   this->desired_mount_orientation_sub_ =
     this->create_subscription<geometry_msgs::msg::Vector3Stamped>(
-    "~/gimbal_goal", 10,
-    std::bind(&GremsyDriver::desiredOrientationCallback, this, std::placeholders::_1));
+    "~/gimbal_goal", goalQos(),
+    std::bind(&GremsyDriver::desiredOrientationCallback, this, std::placeholders::_1),
+    qos_events_->subscriptionOptions(topic_prefix + "/gimbal_goal"));
 
   this->desired_mount_orientation_quaternion_sub_ =
     this->create_subscription<geometry_msgs::msg::QuaternionStamped>(
-    "~/gimbal_goal_quaternion", 10,
-    std::bind(&GremsyDriver::desiredOrientationQuaternionCallback, this, std::placeholders::_1));
+    "~/gimbal_goal_quaternion", goalQos(),
+    std::bind(&GremsyDriver::desiredOrientationQuaternionCallback, this, std::placeholders::_1),
+    qos_events_->subscriptionOptions(topic_prefix + "/gimbal_goal_quaternion"));
 
   // Create services
+  command_callback_group_ = this->create_callback_group(
+    rclcpp::CallbackGroupType::MutuallyExclusive);
   this->enable_lock_mode_service_ =
     this->create_service<std_srvs::srv::SetBool>("~/lock_mode",
-    std::bind(&GremsyDriver::enableLockModeCallback, this, std::placeholders::_1, std::placeholders::_2));
+    std::bind(&GremsyDriver::enableLockModeCallback, this, std::placeholders::_1, std::placeholders::_2),
+    rmw_qos_profile_services_default, command_callback_group_);
+
+  // Create actions
+  this->move_to_server_ = rclcpp_action::create_server<MoveTo>(
+    this, "~/move_to",
+    std::bind(&GremsyDriver::handleMoveToGoal, this, _1, _2),
+    std::bind(&GremsyDriver::handleMoveToCancel, this, _1),
+    std::bind(&GremsyDriver::handleMoveToAccepted, this, _1),
+    rcl_action_server_get_default_options(), command_callback_group_);
+
+  // Reject the baudrates gSDK cannot configure, instead of failing silently in its thread
+  if (!isSupportedBaudrate(baud_rate_)) {
+    RCLCPP_FATAL(this->get_logger(), "Unsupported baudrate %d", baud_rate_);
+    throw std::invalid_argument("Unsupported baudrate");
+  }
+  if (this->get_parameter("baudrate_autoprobe").as_bool()) {
+    // The configured baudrate first, so that a correct configuration is found at once
+    std::vector<int> candidates = {baud_rate_};
+    for (const int64_t candidate : this->get_parameter("baudrate_candidates").as_integer_array()) {
+      if (!isSupportedBaudrate(static_cast<int>(candidate))) {
+        RCLCPP_WARN(this->get_logger(), "Skipping the unsupported baudrate %" PRId64, candidate);
+      } else if (candidate != baud_rate_) {
+        candidates.push_back(static_cast<int>(candidate));
+      }
+    }
+    const int found = probeBaudrate(
+      com_port_, candidates, std::chrono::milliseconds(
+        static_cast<int64_t>(1e3 * this->get_parameter("baudrate_probe_timeout").as_double())));
+    if (found == 0) {
+      RCLCPP_ERROR(this->get_logger(), "No heartbeat at any baudrate, keeping %d", baud_rate_);
+    } else if (found != baud_rate_) {
+      RCLCPP_WARN(this->get_logger(), "Gimbal found at %d baud instead of the configured %d",
+        found, baud_rate_);
+      baud_rate_ = found;
+    }
+  }
+  RCLCPP_INFO(this->get_logger(), "Serial link at %d baud, %.0f bytes/s in each direction",
+    baud_rate_, linkBytesPerSecond(baud_rate_));
+
+  // With the link capture, gSDK talks to a pseudo terminal and the tap forwards to the device
+  std::string sdk_port = com_port_;
+  if (this->get_parameter("link_capture").as_bool()) {
+    LinkCapture::Config capture_config;
+    capture_config.directory = this->get_parameter("link_capture_directory").as_string();
+    capture_config.max_file_size =
+      static_cast<std::size_t>(this->get_parameter("link_capture_file_size").as_int()) << 20;
+    capture_config.max_files =
+      static_cast<std::size_t>(this->get_parameter("link_capture_max_files").as_int());
+    capture_config.buffer_size =
+      static_cast<std::size_t>(this->get_parameter("link_capture_buffer_size").as_int()) << 10;
+    link_capture_ = std::make_unique<LinkCapture>(capture_config);
+    const int device_fd = LinkTap::openSerialDevice(com_port_, baud_rate_);
+    const int pty_fd = LinkTap::openPseudoTerminal(sdk_port);
+    link_tap_ = std::make_unique<LinkTap>(
+      device_fd, pty_fd, link_capture_.get(), [this](const std::string & reason) {
+        RCLCPP_ERROR(this->get_logger(), "Link tap stopped, gSDK is cut off from %s: %s",
+          com_port_.c_str(), reason.c_str());
+      });
+    RCLCPP_INFO(this->get_logger(), "Capturing the serial link of %s to %s",
+      com_port_.c_str(), capture_config.directory.c_str());
+  }
 
   // Define SDK objects
-  serial_port_ = new Serial_Port(com_port_.c_str(), baud_rate_);
+  serial_port_ = new Serial_Port(sdk_port.c_str(), baud_rate_);
   gimbal_interface_ = new Gimbal_Interface(serial_port_);
 
   // Start ther serial interface and the gimbal SDK
   serial_port_->start();
   gimbal_interface_->start();
 
+  // Configuration commands wait for their acknowledgement, and preempt the setpoints
+  CommandScheduler::Config scheduler_config;
+  scheduler_config.ack_timeout = std::chrono::duration<double>(
+    this->get_parameter("command_ack_timeout").as_double());
+  scheduler_config.max_retries = this->get_parameter("command_max_retries").as_int();
+  command_scheduler_ = std::make_unique<CommandScheduler>(
+    scheduler_config,
+    [this](const Eigen::Vector3d & setpoint) {
+      gimbal_interface_->set_gimbal_move(setpoint.y(), setpoint.x(), setpoint.z());
+      GREMSY_TRACEPOINT(serial_write, trace_handle_, "setpoint");
+    },
+    [this]() {
+      const CommandAck ack = readCommandAck(*gimbal_interface_);
+      return CommandScheduler::Ack{ack.time_usec, ack.message.command, ack.message.result};
+    });
+  command_scheduler_->start();
+
   if (gimbal_interface_->get_gimbal_status().mode == GIMBAL_STATE_OFF) {
     RCLCPP_INFO(this->get_logger(), "Gimbal is off, turning it on");
-    gimbal_interface_->set_gimbal_motor_mode(TURN_ON);
+    sendGimbalCommand(
+      "motor on", MAV_CMD_USER_1, [this]() {gimbal_interface_->set_gimbal_motor_mode(TURN_ON);});
   }
+  const double startup_timeout = this->get_parameter("startup_timeout").as_double();
+  const auto startup_deadline = std::chrono::steady_clock::now() +
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(startup_timeout));
   while (gimbal_interface_->get_gimbal_status().mode < GIMBAL_STATE_ON) {
+    if (startup_timeout > 0.0 && std::chrono::steady_clock::now() >= startup_deadline) {
+      RCLCPP_FATAL(this->get_logger(), "Gimbal on %s did not turn on within %.1f s",
+        com_port_.c_str(), startup_timeout);
+      command_scheduler_->stop();
+      gimbal_interface_->stop();
+      serial_port_->stop();
+      throw std::runtime_error("Gimbal did not turn on");
+    }
     RCLCPP_INFO(this->get_logger(), "Waiting for gimbal to turn on");
     std::this_thread::sleep_for(100ms);
   }
 
   // Set gimbal control modes
 
-  gimbal_interface_->set_gimbal_mode(convertIntGimbalMode(gimbal_mode_));
+  sendGimbalCommand("gimbal mode", MAV_CMD_USER_2, gimbalModeCommand(gimbal_mode_));
 
   // Set modes for each axis
 
-  control_gimbal_axis_mode_t tilt_axis_mode, roll_axis_mode, pan_axis_mode;
-  tilt_axis_mode.input_mode = convertIntToAxisInputMode(tilt_axis_input_mode_);
-  tilt_axis_mode.stabilize = tilt_axis_stabilize_;
-  roll_axis_mode.input_mode = convertIntToAxisInputMode(roll_axis_input_mode_);
-  roll_axis_mode.stabilize = roll_axis_stabilize_;
-  pan_axis_mode.input_mode = convertIntToAxisInputMode(pan_axis_input_mode_);
-  pan_axis_mode.stabilize = pan_axis_stabilize_;
+  sendGimbalCommand("axes mode", MAV_CMD_DO_MOUNT_CONFIGURE, axesModeCommand());
 
-  gimbal_interface_->set_gimbal_axes_mode(tilt_axis_mode, roll_axis_mode, pan_axis_mode);
+  // Stream rates, turned down for the streams nobody consumes
+  if (this->get_parameter("request_stream_rates").as_bool()) {
+    stream_rates_ = std::make_unique<StreamRateController>(
+      [this](uint32_t message_id, double rate) {
+        return sendGimbalCommand(
+          "interval of message " + std::to_string(message_id), MAV_CMD_SET_MESSAGE_INTERVAL,
+          [this, message_id, rate]() {
+            // An interval of -1 disables the stream, requested for an idle rate of 0
+            const float interval_usec = rate > 0.0 ? static_cast<float>(1e6 / rate) : -1.0f;
+            // Same sender and target as the commands of gSDK, so that the gimbal routes the
+            // acknowledgement back to it
+            mavlink_message_t message;
+            mavlink_msg_command_long_pack(
+              gimbal_interface_->system_id, gimbal_interface_->companion_id, &message,
+              gimbal_interface_->system_id, gimbal_interface_->gimbal_id,
+              MAV_CMD_SET_MESSAGE_INTERVAL, 0, static_cast<float>(message_id),
+              interval_usec, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+            serial_port_->write_message(message);
+          });
+      });
+    stream_rates_->configure(streamRateConfig(parameter));
+    updateStreamRates();
+    stream_rate_timer_ = this->create_wall_timer(
+      1s, std::bind(&GremsyDriver::updateStreamRates, this), command_callback_group_);
+  }
 
-  pool_timer_ = this->create_wall_timer(
-    std::chrono::duration<double>(1.0 / state_poll_rate_),
-    std::bind(&GremsyDriver::gimbalStateTimerCallback, this));
+  // Diagnostics
+  GimbalDiagnostics::Config diagnostics_config;
+  diagnostics_config.state_rate = state_poll_rate_;
+  diagnostics_config.goal_rate = goal_push_rate_;
+  diagnostics_config.rate_tolerance = this->get_parameter("diagnostics_rate_tolerance").as_double();
+  diagnostics_config.heartbeat_warn_age =
+    this->get_parameter("diagnostics_heartbeat_warn_age").as_double();
+  diagnostics_config.heartbeat_error_age =
+    this->get_parameter("diagnostics_heartbeat_error_age").as_double();
+  diagnostics_config.max_late_goal_ratio =
+    this->get_parameter("diagnostics_max_late_goal_ratio").as_double();
+  diagnostics_config.time_offset_jitter_warn =
+    this->get_parameter("diagnostics_time_offset_jitter_warn").as_double();
+  diagnostics_config.baudrate = baud_rate_;
+  diagnostics_config.max_link_utilization =
+    this->get_parameter("diagnostics_max_link_utilization").as_double();
+  diagnostics_config.hardware_id = std::string("Gremsy ") + device_profile_.name + " " + com_port_;
+  GimbalDiagnostics::Sources diagnostics_sources;
+  diagnostics_sources.gimbal_mode = [this]() {
+      return static_cast<int>(gimbal_interface_->get_gimbal_status().mode);
+    };
+  diagnostics_sources.command_stats = [this]() {return command_scheduler_->stats();};
+  if (link_tap_) {
+    diagnostics_sources.rx_bytes = [this]() {return link_tap_->rxBytes();};
+    diagnostics_sources.tx_bytes = [this]() {return link_tap_->txBytes();};
+    diagnostics_sources.link_tap_error = [this]() {return link_tap_->stopReason();};
+  }
+  diagnostics_sources.qos_events = [this]() {return qos_events_->counts();};
+  if (stream_rates_) {
+    diagnostics_sources.stream_rates = [this]() {return stream_rates_->requested();};
+  }
+  diagnostics_ = std::make_unique<GimbalDiagnostics>(this, diagnostics_config, diagnostics_sources);
 
-  goal_timer_ = this->create_wall_timer(
-    std::chrono::duration<double>(1.0 / goal_push_rate_),
-    std::bind(&GremsyDriver::gimbalGoalTimerCallback, this));
+  // The state is polled from a thread of the driver instead of the executor if enabled
+  if (this->get_parameter("state_publisher_thread").as_bool()) {
+    PeriodicThread::Config thread_config;
+    thread_config.priority =
+      static_cast<int>(this->get_parameter("state_publisher_thread_priority").as_int());
+    for (const int64_t cpu : this->get_parameter("state_publisher_thread_cpus").as_integer_array()) {
+      thread_config.cpus.push_back(static_cast<int>(cpu));
+    }
+    state_thread_ = std::make_unique<PeriodicThread>(
+      thread_config, [this](PeriodicThread::Clock::time_point) {gimbalStateTimerCallback();});
+    if (!state_thread_->start(periodOf(state_poll_rate_))) {
+      RCLCPP_WARN(this->get_logger(), "Could not set the priority or affinity of the state "
+        "publisher thread, it needs CAP_SYS_NICE for a real-time priority");
+    }
+    RCLCPP_INFO(this->get_logger(), "Publishing the gimbal state from a dedicated thread");
+  } else {
+    createPollTimer(state_poll_rate_);
+  }
+  if (adaptive_poll_rate_) {
+    poll_rate_adapter_.configure(
+      pollRateAdapterConfig(parameter), state_poll_rate_, PollRateAdapter::Clock::now());
+    // Same callback group as the parameters, the state publisher thread polls under the mutex
+    poll_rate_timer_ = this->create_wall_timer(1s, std::bind(&GremsyDriver::adaptPollRate, this));
+  }
+
+  createGoalTimer(goal_push_rate_);
 
+  // Rates, modes and limits can be changed at runtime, the other parameters are read-only
+  parameters_callback_handle_ = this->add_on_set_parameters_callback(
+    std::bind(&GremsyDriver::parametersCallback, this, _1));
 }
 GremsyDriver::~GremsyDriver()
 {
+  move_to_stop_ = true;
+  if (move_to_thread_.joinable()) {
+    move_to_thread_.join();
+  }
+  if (state_thread_) {
+    state_thread_->stop();
+    const PeriodicThread::Stats stats = state_thread_->stats();
+    RCLCPP_INFO(this->get_logger(),
+      "State publisher thread ticks: %" PRIu64 ", overruns: %" PRIu64, stats.ticks, stats.overruns);
+  }
+  if (command_scheduler_) {
+    command_scheduler_->stop();
+    const CommandScheduler::Stats stats = command_scheduler_->stats();
+    RCLCPP_INFO(this->get_logger(),
+      "Gimbal commands: %" PRIu64 ", acknowledged: %" PRIu64 ", retries: %" PRIu64 ", "
+      "failed: %" PRIu64 ", mean ACK round-trip: %.1f ms", stats.commands, stats.acked,
+      stats.retries, stats.failed, stats.mean_rtt_ms);
+  }
+  const SetpointFilter::Counters & counters = setpoint_filter_.counters();
+  RCLCPP_INFO(this->get_logger(),
+    "Gimbal setpoints sent: %" PRIu64 ", suppressed: %" PRIu64 ", keepalive: %" PRIu64,
+    counters.sent, counters.suppressed, counters.keepalive);
+  if (link_capture_) {
+    const LinkCapture::Stats stats = link_capture_->stats();
+    RCLCPP_INFO(this->get_logger(),
+      "Link capture records: %" PRIu64 " (%" PRIu64 " bytes), dropped: %" PRIu64 " "
+      "(%" PRIu64 " bytes), files: %" PRIu64, stats.records, stats.bytes,
+      stats.dropped_records, stats.dropped_bytes, stats.files);
+  }
   // TODO: Close serial port
 }
 
 void GremsyDriver::gimbalStateTimerCallback()
 {
   //RCLCPP_DEBUG(this->get_logger(), "Gimbal state timer callback");
-  // Publish Gimbal IMU
-  mavlink_raw_imu_t imu_mav = gimbal_interface_->get_gimbal_raw_imu();
-  imu_mav.time_usec = gimbal_interface_->get_gimbal_time_stamps().raw_imu;
-  sensor_msgs::msg::Imu imu_ros_mag = convertImuMavlinkMessageToROSMessage(imu_mav);
-
-  imu_ros_mag.header.stamp = use_ros_time_ ? this->get_clock()->now() : rclcpp::Time(
-    (int64_t)imu_mav.time_usec * 1000UL);
-  imu_pub_->publish(imu_ros_mag);
-
-  // Publish Gimbal Encoder Values
-  mavlink_mount_status_t mount_status = gimbal_interface_->get_gimbal_mount_status();
-  uint64_t mnt_status_time_stamp = gimbal_interface_->get_gimbal_time_stamps().mount_status;
-  // TODO: Confirm that the mount status timestamp is in microseconds
-
-  geometry_msgs::msg::Vector3Stamped encoder_ros_msg;
-
-  encoder_ros_msg.header.stamp = use_ros_time_ ? this->get_clock()->now() : rclcpp::Time(
-    (int64_t)mnt_status_time_stamp * 1000UL);
-
-  encoder_ros_msg.vector.x = ((float) mount_status.pointing_b) * DEG_TO_RAD;
-  encoder_ros_msg.vector.y = ((float) mount_status.pointing_a) * DEG_TO_RAD;
-  encoder_ros_msg.vector.z = ((float) mount_status.pointing_c) * DEG_TO_RAD;
-  // encoder_ros_msg.header TODO time stamps
-
-  encoder_pub_->publish(encoder_ros_msg);
-
-  // Get Mount Orientation
-  mavlink_mount_orientation_t mount_orientation = gimbal_interface_->get_gimbal_mount_orientation();
-  mount_orientation.time_boot_ms = gimbal_interface_->get_gimbal_time_stamps().mount_orientation;
-
-  rclcpp::Time stamp = use_ros_time_ ? this->get_clock()->now() : rclcpp::Time(
-    (int64_t)mount_orientation.time_boot_ms * 1000000UL);
-
-  yaw_difference_ = DEG_TO_RAD * (mount_orientation.yaw_absolute - mount_orientation.yaw);
-
-  // Publish Camera Mount Orientation in global frame (drifting)
-  mount_orientation_global_pub_->publish(
-    stampQuaternion(
-      tf2::toMsg(
-        convertXYZtoQuaternion(
-          mount_orientation.roll,
-          mount_orientation.pitch,
-          mount_orientation.yaw_absolute)),
-      "gimbal_link", stamp));
-
-  // Publish Camera Mount Orientation in local frame (yaw relative to vehicle)
-  mount_orientation_local_pub_->publish(
-    stampQuaternion(
-      tf2::toMsg(
-        convertXYZtoQuaternion(
-          mount_orientation.roll,
-          mount_orientation.pitch,
-          mount_orientation.yaw)),
-      "gimbal_link", stamp));
+  DriverState state;
+  state.gimbal = readGimbalState(*gimbal_interface_);
+  GREMSY_TRACEPOINT(
+    state_snapshot, trace_handle_, state.gimbal.raw_imu.time_usec,
+    state.gimbal.mount_status_time_usec, state.gimbal.mount_orientation_time_usec);
+  const mavlink_mount_orientation_t & mount_orientation = state.gimbal.mount_orientation;
+  state.yaw_difference = DEG_TO_RAD * (mount_orientation.yaw_absolute - mount_orientation.yaw);
+  // A zero stamp is the zeroed message before the first mount status, not a reading
+  if (state.gimbal.mount_status_time_usec != 0) {
+    pan_tracker_.update(state.gimbal.mount_status.pointing_c);
+  }
+  state.pan_initialized = pan_tracker_.initialized();
+  state.pan_angle = pan_tracker_.angle();
+  driver_state_.store(state);
+
+  state_publisher_->publish(state.gimbal);
+  diagnostics_->stateTick(state.gimbal);
+  if (adaptive_poll_rate_) {
+    std::lock_guard<std::mutex> lock(poll_rate_mutex_);
+    poll_rate_adapter_.poll(state.gimbal);
+  }
+}
+
+void GremsyDriver::adaptPollRate()
+{
+  double previous, rate, stream_rate;
+  {
+    std::lock_guard<std::mutex> lock(poll_rate_mutex_);
+    previous = poll_rate_adapter_.rate();
+    rate = poll_rate_adapter_.adapt(PollRateAdapter::Clock::now());
+    stream_rate = poll_rate_adapter_.streamRate();
+  }
+  if (rate != previous) {
+    RCLCPP_INFO(this->get_logger(), "State poll rate %.1f Hz, fastest stream at least %.1f Hz",
+      rate, stream_rate);
+    createPollTimer(rate);
+    diagnostics_->setStateRate(rate);
+  }
+}
+
+std::chrono::nanoseconds GremsyDriver::periodOf(double rate)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(1.0 / rate));
+}
+
+void GremsyDriver::createPollTimer(double rate)
+{
+  if (state_thread_) {
+    state_thread_->setPeriod(periodOf(rate));
+    return;
+  }
+  if (pool_timer_) {
+    pool_timer_->cancel();
+  }
+  pool_timer_ = this->create_wall_timer(
+    periodOf(rate), std::bind(&GremsyDriver::gimbalStateTimerCallback, this));
+}
+
+void GremsyDriver::createGoalTimer(double rate)
+{
+  if (goal_timer_) {
+    goal_timer_->cancel();
+  }
+  goal_timer_ = this->create_wall_timer(
+    std::chrono::duration<double>(1.0 / rate),
+    std::bind(&GremsyDriver::gimbalGoalTimerCallback, this));
 }
 
 void GremsyDriver::gimbalGoalTimerCallback()
 {
   // RCLCPP_DEBUG(this->get_logger(), "Gimbal goal timer callback");
-  if (goal_) {
+  diagnostics_->goalTick();
+  geometry_msgs::msg::Vector3 goal;
+  bool new_goal;
+  {
+    std::lock_guard<std::mutex> lock(goal_mutex_);
+    new_goal = goal_pending_;
+    goal = goal_;
+    goal_pending_ = false;
+  }
+  if (new_goal) {
     RCLCPP_DEBUG(this->get_logger(), "Gimbal desired orientation is: %f, %f, %f",
-      goal_->vector.x, goal_->vector.y, goal_->vector.z);
-    Eigen::Vector3d desired_orientation_eigen = prepareGimbalMove(
-      goal_, device_id_, lock_yaw_to_vehicle_, yaw_difference_);
+      goal.x, goal.y, goal.z);
+    const DriverState state = driver_state_.load();
+    Eigen::Vector3d desired_orientation_eigen = prepare_gimbal_move_(
+      goal, lock_yaw_to_vehicle_, state.yaw_difference, currentPan(state));
     RCLCPP_DEBUG(this->get_logger(), "Desired orientation: %f, %f, %f",
       desired_orientation_eigen(0), desired_orientation_eigen(1), desired_orientation_eigen(2));
-    gimbal_interface_->set_gimbal_move(
-      desired_orientation_eigen.y(),
-      desired_orientation_eigen.x(),
-      desired_orientation_eigen.z());
-    goal_ = nullptr;
+
+    if (!setpoint_shaping_) {
+      sendGimbalMove(desired_orientation_eigen);
+      return;
+    }
+    // A new profile starts from the current orientation, which may have changed since the
+    // last one settled, e.g. moved by RC or by the gimbal drifting while idle
+    if (!shaper_.initialized() || shaper_.settled()) {
+      shaper_.reset(measuredGimbalMove(state));
+    }
+    shaper_.setTarget(desired_orientation_eigen);
   }
+
+  if (setpoint_shaping_ && !shaper_.settled()) {
+    sendGimbalMove(shaper_.step(1.0 / goal_push_rate_));
+    // The last steps of a profile can be within the deadband, the target itself is always sent
+    if (!shaper_.settled() || !setpoint_filter_.flush(SetpointFilter::Clock::now())) {
+      return;
+    }
+  } else if (!setpoint_filter_.keepalive(SetpointFilter::Clock::now())) {
+    return;
+  }
+  const Eigen::Vector3d & setpoint = setpoint_filter_.latest();
+  GREMSY_TRACEPOINT(goal_sent, trace_handle_, setpoint.x(), setpoint.y(), setpoint.z());
+  command_scheduler_->submitSetpoint(setpoint);
+}
+
+void GremsyDriver::sendGimbalMove(const Eigen::Vector3d & setpoint)
+{
+  if (!setpoint_filter_.accept(setpoint, SetpointFilter::Clock::now())) {
+    const SetpointFilter::Counters & counters = setpoint_filter_.counters();
+    RCLCPP_DEBUG_THROTTLE(this->get_logger(), *this->get_clock(), 5000,
+      "Gimbal setpoints sent: %" PRIu64 ", suppressed: %" PRIu64 ", keepalive: %" PRIu64,
+      counters.sent, counters.suppressed, counters.keepalive);
+    return;
+  }
+  GREMSY_TRACEPOINT(goal_sent, trace_handle_, setpoint.x(), setpoint.y(), setpoint.z());
+  command_scheduler_->submitSetpoint(setpoint);
+}
+
+const char * GremsyDriver::undocumentedAxisInputMode(const ParameterLookup & parameter) const
+{
+  const std::pair<const char *, uint8_t> axes[] = {
+    {"tilt", device_profile_.tilt_input_modes},
+    {"roll", device_profile_.roll_input_modes},
+    {"pan", device_profile_.pan_input_modes},
+  };
+  for (const auto & axis : axes) {
+    const int mode = parameter(std::string(axis.first) + "_axis_input_mode").as_int();
+    if ((axis.second & axisInputModeBit(mode)) == 0) {
+      return axis.first;
+    }
+  }
+  return nullptr;
+}
+
+bool GremsyDriver::readShaperLimits(
+  const ParameterLookup & parameter, SetpointShaper::Limits & limits) const
+{
+  const std::vector<double> max_velocity = parameter("shaper_max_velocity").as_double_array();
+  const std::vector<double> max_acceleration =
+    parameter("shaper_max_acceleration").as_double_array();
+  const std::vector<double> max_jerk = parameter("shaper_max_jerk").as_double_array();
+  if (max_velocity.size() != 3 || max_acceleration.size() != 3 || max_jerk.size() != 3) {
+    return false;
+  }
+  limits.velocity = Eigen::Vector3d(max_velocity.data());
+  limits.acceleration = Eigen::Vector3d(max_acceleration.data());
+  limits.jerk = Eigen::Vector3d(max_jerk.data());
+  // Goals of the axes in angular rate mode are rates, they are passed through unshaped
+  const char * const axes[3] = {"roll", "tilt", "pan"};
+  for (int axis = 0; axis < 3; ++axis) {
+    if (parameter(std::string(axes[axis]) + "_axis_input_mode").as_int() == 1) {
+      limits.velocity[axis] = 0.0;
+    }
+  }
+  return true;
+}
+
+bool GremsyDriver::readFilterConfig(
+  const ParameterLookup & parameter, SetpointFilter::Config & config) const
+{
+  const std::vector<double> deadband = parameter("goal_deadband").as_double_array();
+  config.hysteresis = parameter("goal_deadband_hysteresis").as_double();
+  config.keepalive_period = std::chrono::duration<double>(
+    parameter("goal_keepalive_period").as_double());
+  if (deadband.size() != 3) {
+    return false;
+  }
+  config.deadband = Eigen::Vector3d(deadband.data());
+  return true;
+}
+
+PollRateAdapter::Config GremsyDriver::pollRateAdapterConfig(
+  const ParameterLookup & parameter) const
+{
+  PollRateAdapter::Config config;
+  config.min_rate = parameter("adaptive_poll_min_rate").as_double();
+  config.max_rate = parameter("adaptive_poll_max_rate").as_double();
+  config.margin = parameter("adaptive_poll_margin").as_double();
+  return config;
+}
+
+StreamRateController::Config GremsyDriver::streamRateConfig(
+  const ParameterLookup & parameter) const
+{
+  // Zero follows the state poll rate, faster streams would only be overwritten between polls
+  const double state_poll_rate = parameter("state_poll_rate").as_double();
+  const auto rate = [&parameter, state_poll_rate](const char * name) {
+      const double rate = parameter(name).as_double();
+      return rate == 0.0 ? state_poll_rate : rate;
+    };
+  StreamRateController::Config config;
+  config.rates[StreamRateController::RAW_IMU] = rate("imu_stream_rate");
+  config.rates[StreamRateController::MOUNT_STATUS] = rate("encoder_stream_rate");
+  config.rates[StreamRateController::MOUNT_ORIENTATION] = rate("mount_orientation_stream_rate");
+  config.idle_rate = parameter("stream_idle_rate").as_double();
+  return config;
+}
+
+void GremsyDriver::updateStreamRates()
+{
+  std::array<bool, StreamRateController::NUM_STREAMS> consumed =
+    state_publisher_->consumedStreams();
+  // The goals are relative to the mount orientation, and continuous yaw follows the encoder
+  consumed[StreamRateController::MOUNT_ORIENTATION] = true;
+  consumed[StreamRateController::MOUNT_STATUS] =
+    consumed[StreamRateController::MOUNT_STATUS] || continuous_yaw_;
+
+  const StreamRateController::Rates previous = stream_rates_->requested();
+  if (!stream_rates_->update(consumed)) {
+    RCLCPP_WARN(this->get_logger(), "The gimbal did not accept all stream rates, "
+      "they are left to the gimbal until the rates are configured again");
+  }
+  const StreamRateController::Rates requested = stream_rates_->requested();
+  for (int i = 0; i < StreamRateController::NUM_STREAMS; ++i) {
+    if (requested[i] != previous[i]) {
+      RCLCPP_INFO(this->get_logger(), "Requested the %s stream at %.1f Hz",
+        StreamRateController::name(static_cast<StreamRateController::Stream>(i)), requested[i]);
+    }
+  }
+}
+
+std::shared_future<bool> GremsyDriver::submitGimbalCommand(
+  const std::string & name, uint16_t command, CommandScheduler::CommandFunction send)
+{
+  return command_scheduler_->submitCommand(
+    name, command, [this, name, send = std::move(send)]() {
+      send();
+      GREMSY_TRACEPOINT(serial_write, trace_handle_, name.c_str());
+    });
+}
+
+bool GremsyDriver::sendGimbalCommand(
+  const std::string & name, uint16_t command, CommandScheduler::CommandFunction send)
+{
+  const bool acked = submitGimbalCommand(name, command, std::move(send)).get();
+  if (acked) {
+    RCLCPP_DEBUG(this->get_logger(), "Gimbal accepted %s in %.1f ms",
+      name.c_str(), command_scheduler_->stats().last_rtt_ms);
+  } else {
+    RCLCPP_WARN(this->get_logger(), "Gimbal command failed: %s",
+      command_scheduler_->lastFailedCommand().c_str());
+  }
+  return acked;
+}
+
+CommandScheduler::CommandFunction GremsyDriver::gimbalModeCommand(int mode)
+{
+  return [this, mode = convertIntGimbalMode(mode)]() {
+           gimbal_interface_->set_gimbal_mode(mode);
+         };
+}
+
+CommandScheduler::CommandFunction GremsyDriver::axesModeCommand()
+{
+  control_gimbal_axis_mode_t tilt_axis_mode, roll_axis_mode, pan_axis_mode;
+  tilt_axis_mode.input_mode = convertIntToAxisInputMode(tilt_axis_input_mode_);
+  tilt_axis_mode.stabilize = tilt_axis_stabilize_;
+  roll_axis_mode.input_mode = convertIntToAxisInputMode(roll_axis_input_mode_);
+  roll_axis_mode.stabilize = roll_axis_stabilize_;
+  pan_axis_mode.input_mode = convertIntToAxisInputMode(pan_axis_input_mode_);
+  pan_axis_mode.stabilize = pan_axis_stabilize_;
+  return [this, tilt_axis_mode, roll_axis_mode, pan_axis_mode]() {
+           gimbal_interface_->set_gimbal_axes_mode(tilt_axis_mode, roll_axis_mode, pan_axis_mode);
+         };
+}
+
+Eigen::Vector3d GremsyDriver::measuredGimbalMove(const DriverState & state) const
+{
+  const mavlink_mount_orientation_t & mount_orientation = state.gimbal.mount_orientation;
+  const double yaw_offset = lock_yaw_to_vehicle_ ? 0.0 : RAD_TO_DEG * state.yaw_difference;
+  double yaw = mount_orientation.yaw + yaw_offset;
+  // Same turn as the encoder, so that the yaw is continuous past +-180 degrees
+  if (continuous_yaw_ && state.pan_initialized) {
+    yaw = unwrapNear(yaw, state.pan_angle + yaw_offset);
+  }
+  return Eigen::Vector3d(mount_orientation.roll, mount_orientation.pitch, yaw);
+}
+
+std::optional<double> GremsyDriver::currentPan(const DriverState & state) const
+{
+  if (!continuous_yaw_ || !state.pan_initialized) {
+    return std::nullopt;
+  }
+  return state.pan_angle + (lock_yaw_to_vehicle_ ? 0.0 : RAD_TO_DEG * state.yaw_difference);
 }
 
 void GremsyDriver::desiredOrientationCallback(
   const geometry_msgs::msg::Vector3Stamped::SharedPtr msg)
 {
   RCLCPP_INFO(this->get_logger(), "New goal received: x: '%.2f', y: '%.2f', z: '%.2f'", msg->vector.x, msg->vector.y, msg->vector.z);
-  goal_ = msg;
+  setGoal(msg->vector);
 }
 
 void GremsyDriver::desiredOrientationQuaternionCallback(
@@ -204,17 +712,145 @@ void GremsyDriver::desiredOrientationQuaternionCallback(
   // The easiest way to fix this is to send the conjugate of the parameter quaternion.
   Eigen::Vector3d angles = convertQuaterniontoZYX(msg->quaternion.x, msg->quaternion.y, msg->quaternion.z, -msg->quaternion.w);
 
-  // goal_ requires a Vector3Stamped, so we convert the message type
-  std::shared_ptr<geometry_msgs::msg::Vector3Stamped> message = std::make_shared<geometry_msgs::msg::Vector3Stamped>();
-  message->header.stamp = msg->header.stamp;
-  message->header.frame_id = msg->header.frame_id;
   // The conjugate angles have the opposite sign, so we negate them.
-  message->vector.x = -angles[0];
-  message->vector.y = -angles[1];
-  message->vector.z = -angles[2];
+  geometry_msgs::msg::Vector3 goal;
+  goal.x = -angles[0];
+  goal.y = -angles[1];
+  goal.z = -angles[2];
 
-  RCLCPP_INFO(this->get_logger(), "New quaternion goal received: x: '%.2f', y: '%.2f', z: '%.2f'", message->vector.x, message->vector.y, message->vector.z);
-  goal_ = message;
+  RCLCPP_INFO(this->get_logger(), "New quaternion goal received: x: '%.2f', y: '%.2f', z: '%.2f'", goal.x, goal.y, goal.z);
+  setGoal(goal);
+}
+
+void GremsyDriver::setGoal(const geometry_msgs::msg::Vector3 & goal)
+{
+  GREMSY_TRACEPOINT(goal_received, trace_handle_, goal.x, goal.y, goal.z);
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  goal_ = goal;
+  goal_pending_ = true;
+  // A goal from the topics preempts the MoveTo action
+  active_move_to_ = nullptr;
+}
+
+rclcpp_action::GoalResponse GremsyDriver::handleMoveToGoal(
+  const rclcpp_action::GoalUUID & /*uuid*/,
+  std::shared_ptr<const MoveTo::Goal> goal)
+{
+  if (goal->tolerance <= 0.0) {
+    RCLCPP_WARN(this->get_logger(), "Rejecting MoveTo goal with non-positive tolerance");
+    return rclcpp_action::GoalResponse::REJECT;
+  }
+  RCLCPP_INFO(this->get_logger(), "New MoveTo goal received: x: '%.2f', y: '%.2f', z: '%.2f'",
+    goal->target.x, goal->target.y, goal->target.z);
+  return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+}
+
+rclcpp_action::CancelResponse GremsyDriver::handleMoveToCancel(
+  const std::shared_ptr<GoalHandleMoveTo> /*goal_handle*/)
+{
+  return rclcpp_action::CancelResponse::ACCEPT;
+}
+
+void GremsyDriver::handleMoveToAccepted(const std::shared_ptr<GoalHandleMoveTo> goal_handle)
+{
+  {
+    std::lock_guard<std::mutex> lock(goal_mutex_);
+    goal_ = goal_handle->get_goal()->target;
+    goal_pending_ = true;
+    active_move_to_ = goal_handle;
+  }
+  // The previous goal sees it is preempted within one of its ticks
+  if (move_to_thread_.joinable()) {
+    move_to_thread_.join();
+  }
+  move_to_thread_ = std::thread(&GremsyDriver::executeMoveTo, this, goal_handle);
+}
+
+void GremsyDriver::executeMoveTo(const std::shared_ptr<GoalHandleMoveTo> goal_handle)
+{
+  const std::shared_ptr<const MoveTo::Goal> goal = goal_handle->get_goal();
+  auto feedback = std::make_shared<MoveTo::Feedback>();
+  auto result = std::make_shared<MoveTo::Result>();
+
+  const geometry_msgs::msg::Vector3 & target = goal->target;
+  const rclcpp::Time start = this->get_clock()->now();
+  rclcpp::Time inside_since = start;
+  bool inside = false;
+  rclcpp::Rate rate(state_poll_rate_);
+
+  while (rclcpp::ok() && !move_to_stop_) {
+    // Compare in the frame of the commands, so that clamping to the device limits is accounted for
+    const DriverState state = driver_state_.load();
+    const Eigen::Vector3d error_deg = prepare_gimbal_move_(
+      target, lock_yaw_to_vehicle_, state.yaw_difference, currentPan(state)) -
+      measuredGimbalMove(state);
+    const Eigen::Vector3d error(
+      DEG_TO_RAD * error_deg.x(),
+      DEG_TO_RAD * error_deg.y(),
+      DEG_TO_RAD * wrapAngle(error_deg.z()));
+    const rclcpp::Time now = this->get_clock()->now();
+
+    result->error.x = feedback->error.x = error.x();
+    result->error.y = feedback->error.y = error.y();
+    result->error.z = feedback->error.z = error.z();
+    result->elapsed = (now - start).seconds();
+
+    if (goal_handle->is_canceling()) {
+      result->success = false;
+      goal_handle->canceled(result);
+      RCLCPP_INFO(this->get_logger(), "MoveTo goal canceled");
+      break;
+    }
+    {
+      std::lock_guard<std::mutex> lock(goal_mutex_);
+      if (active_move_to_ != goal_handle) {
+        result->success = false;
+        goal_handle->abort(result);
+        RCLCPP_INFO(this->get_logger(), "MoveTo goal preempted by a new goal");
+        break;
+      }
+    }
+
+    if (error.cwiseAbs().maxCoeff() <= goal->tolerance) {
+      if (!inside) {
+        inside = true;
+        inside_since = now;
+      }
+    } else {
+      inside = false;
+    }
+    feedback->settled_for = inside ? (now - inside_since).seconds() : 0.0;
+
+    if (inside && feedback->settled_for >= goal->settle_time) {
+      result->success = true;
+      goal_handle->succeed(result);
+      RCLCPP_INFO(this->get_logger(), "MoveTo goal reached in %.2f s", result->elapsed);
+      break;
+    }
+    if (goal->timeout > 0.0 && result->elapsed >= goal->timeout) {
+      result->success = false;
+      goal_handle->abort(result);
+      RCLCPP_WARN(this->get_logger(), "MoveTo goal timed out after %.2f s", result->elapsed);
+      break;
+    }
+
+    const mavlink_mount_status_t & mount_status = state.gimbal.mount_status;
+    feedback->encoder.x = ((float) mount_status.pointing_b) * DEG_TO_RAD;
+    feedback->encoder.y = ((float) mount_status.pointing_a) * DEG_TO_RAD;
+    feedback->encoder.z = ((float) mount_status.pointing_c) * DEG_TO_RAD;
+    goal_handle->publish_feedback(feedback);
+    rate.sleep();
+  }
+  if (goal_handle->is_active()) {
+    result->success = false;
+    goal_handle->abort(result);
+    RCLCPP_WARN(this->get_logger(), "MoveTo goal aborted, the driver is shutting down");
+  }
+
+  std::lock_guard<std::mutex> lock(goal_mutex_);
+  if (active_move_to_ == goal_handle) {
+    active_move_to_ = nullptr;
+  }
 }
 
 void GremsyDriver::enableLockModeCallback(const std::shared_ptr<std_srvs::srv::SetBool::Request> request,
@@ -225,38 +861,223 @@ void GremsyDriver::enableLockModeCallback(const std::shared_ptr<std_srvs::srv::S
     response->success = true;
     response->message = "Gimbal is already in requested mode.";
     RCLCPP_WARN(this->get_logger(), "Gimbal mode unchanged, is already in %s mode.", gimbal_mode_ == 1 ? "lock" : "follow");
+  } else if (!sendGimbalCommand("gimbal mode", MAV_CMD_USER_2, gimbalModeCommand(new_mode))) {
+    response->success = false;
+    response->message = "Gimbal did not accept the mode change.";
   } else {
-    // Set new mode internally and to parameters.
+    // Set new mode internally and to parameters, the parameter callback sees it is applied
     gimbal_mode_ = new_mode;
-    this->set_parameter(rclcpp::Parameter("gimbal_mode", gimbal_mode_));
-    gimbal_interface_->set_gimbal_mode(convertIntGimbalMode(gimbal_mode_));
+    this->set_parameter(rclcpp::Parameter("gimbal_mode", new_mode));
 
     response->success = true;
     response->message = "Gimbal mode successfully changed.";
 
-    RCLCPP_INFO(this->get_logger(), "Changing gimbal mode to %s.", gimbal_mode_ == 1 ? "lock" : "follow");
+    RCLCPP_INFO(this->get_logger(), "Changing gimbal mode to %s.", new_mode == 1 ? "lock" : "follow");
+    }
+}
+
+rcl_interfaces::msg::SetParametersResult GremsyDriver::parametersCallback(
+  const std::vector<rclcpp::Parameter> & parameters)
+{
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  std::set<std::string> changed_names;
+  for (const rclcpp::Parameter & value : parameters) {
+    changed_names.insert(value.get_name());
+  }
+  const auto changed = [&changed_names](std::initializer_list<const char *> names) {
+      for (const char * name : names) {
+        if (changed_names.count(name) != 0) {
+          return true;
+        }
+      }
+      return false;
+    };
+  // New values of the changed parameters, current values of the others
+  const ParameterLookup parameter = [this, &parameters](const std::string & name) {
+      for (const rclcpp::Parameter & value : parameters) {
+        if (value.get_name() == name) {
+          return value;
+        }
+      }
+      return this->get_parameter(name);
+    };
+
+  // Validate all the changes before applying any
+  SetpointShaper::Limits limits;
+  SetpointFilter::Config filter_config;
+  const bool setpoint_shaping = parameter("setpoint_shaping").as_bool();
+  if (parameter("state_poll_rate").as_double() <= 0.0) {
+    result.reason = "state_poll_rate must be positive";
+  } else if (parameter("goal_push_rate").as_double() <= 0.0) {
+    result.reason = "goal_push_rate must be positive";
+  } else if (changed({"setpoint_shaping", "shaper_max_velocity", "shaper_max_acceleration",
+      "shaper_max_jerk", "tilt_axis_input_mode", "roll_axis_input_mode",
+      "pan_axis_input_mode", "goal_push_rate"}) && setpoint_shaping &&
+    !readShaperLimits(parameter, limits))
+  {
+    result.reason = "Setpoint shaper limits need 3 values (roll, tilt, pan)";
+  } else if (changed({"setpoint_shaping", "shaper_max_velocity", "shaper_max_acceleration",
+      "shaper_max_jerk", "tilt_axis_input_mode", "roll_axis_input_mode",
+      "pan_axis_input_mode", "goal_push_rate"}) && setpoint_shaping &&
+    !SetpointShaper::validLimits(limits, 1.0 / parameter("goal_push_rate").as_double()))
+  {
+    result.reason = "Setpoint shaper limits cannot be followed at the goal_push_rate, "
+      "one tick of jerk exceeds the acceleration or velocity limit";
+  } else if (changed({"goal_deadband", "goal_deadband_hysteresis", "goal_keepalive_period"}) &&
+    !readFilterConfig(parameter, filter_config))
+  {
+    result.reason = "goal_deadband needs 3 values (roll, tilt, pan)";
+  } else if (parameter("adaptive_poll_min_rate").as_double() >
+    parameter("adaptive_poll_max_rate").as_double())
+  {
+    result.reason = "adaptive_poll_min_rate is above adaptive_poll_max_rate";
+  }
+  if (!result.reason.empty()) {
+    result.successful = false;
+    RCLCPP_WARN(this->get_logger(), "Rejected parameter change: %s", result.reason.c_str());
+    return result;
+  }
+
+  // The timers are in the same callback group as this callback, and are replaced between ticks
+  if (changed({"state_poll_rate", "adaptive_poll_rate", "adaptive_poll_min_rate",
+      "adaptive_poll_max_rate", "adaptive_poll_margin"}))
+  {
+    const bool restart = changed({"state_poll_rate", "adaptive_poll_rate"});
+    state_poll_rate_ = parameter("state_poll_rate").as_double();
+    adaptive_poll_rate_ = parameter("adaptive_poll_rate").as_bool();
+    double rate = state_poll_rate_;
+    if (adaptive_poll_rate_) {
+      // A new initial rate starts the adaptation over, new bounds keep the adapted rate
+      std::lock_guard<std::mutex> lock(poll_rate_mutex_);
+      poll_rate_adapter_.configure(
+        pollRateAdapterConfig(parameter), restart ? rate : poll_rate_adapter_.rate(),
+        PollRateAdapter::Clock::now());
+      rate = poll_rate_adapter_.rate();
+      if (!poll_rate_timer_) {
+        poll_rate_timer_ = this->create_wall_timer(
+          1s, std::bind(&GremsyDriver::adaptPollRate, this));
+      }
+    } else if (poll_rate_timer_) {
+      poll_rate_timer_->cancel();
+      poll_rate_timer_.reset();
+    }
+    createPollTimer(rate);
+    diagnostics_->setStateRate(rate);
+    RCLCPP_INFO(this->get_logger(), "State poll rate %.1f Hz%s", rate,
+      adaptive_poll_rate_ ? ", adaptive" : "");
+  }
+  if (changed({"goal_push_rate"})) {
+    goal_push_rate_ = parameter("goal_push_rate").as_double();
+    createGoalTimer(goal_push_rate_);
+    diagnostics_->setGoalRate(goal_push_rate_);
+    RCLCPP_INFO(this->get_logger(), "Goal push rate %.1f Hz", goal_push_rate_);
+  }
+  if (stream_rates_ && changed({"state_poll_rate", "imu_stream_rate", "encoder_stream_rate",
+      "mount_orientation_stream_rate", "stream_idle_rate"}))
+  {
+    // Requested by the stream rate timer
+    stream_rates_->configure(streamRateConfig(parameter));
+  }
+
+  // The gimbal commands are queued without waiting for their acknowledgement, which would
+  // stall the timers, a missing one shows in the diagnostics. The lock mode service sets
+  // gimbal_mode after the gimbal acknowledged it, it is not sent again.
+  const int gimbal_mode = parameter("gimbal_mode").as_int();
+  if (gimbal_mode != gimbal_mode_) {
+    gimbal_mode_ = gimbal_mode;
+    submitGimbalCommand("gimbal mode", MAV_CMD_USER_2, gimbalModeCommand(gimbal_mode));
+    RCLCPP_INFO(this->get_logger(), "Changing gimbal mode to %d", gimbal_mode);
+  }
+  if (changed({"tilt_axis_input_mode", "tilt_axis_stabilize", "roll_axis_input_mode",
+      "roll_axis_stabilize", "pan_axis_input_mode", "pan_axis_stabilize"}))
+  {
+    tilt_axis_input_mode_ = parameter("tilt_axis_input_mode").as_int();
+    tilt_axis_stabilize_ = parameter("tilt_axis_stabilize").as_bool();
+    roll_axis_input_mode_ = parameter("roll_axis_input_mode").as_int();
+    roll_axis_stabilize_ = parameter("roll_axis_stabilize").as_bool();
+    pan_axis_input_mode_ = parameter("pan_axis_input_mode").as_int();
+    pan_axis_stabilize_ = parameter("pan_axis_stabilize").as_bool();
+    if (const char * axis = undocumentedAxisInputMode(parameter)) {
+      RCLCPP_WARN(this->get_logger(),
+        "Gremsy %s is not documented to support the %s_axis_input_mode, it may be rejected",
+        device_profile_.name, axis);
+    }
+    submitGimbalCommand("axes mode", MAV_CMD_DO_MOUNT_CONFIGURE, axesModeCommand());
+    RCLCPP_INFO(this->get_logger(), "Changing the axes mode");
+  }
+
+  // Goal handling, in the callback group of the goal timer
+  if (changed({"lock_yaw_to_vehicle", "continuous_yaw", "setpoint_shaping"})) {
+    lock_yaw_to_vehicle_ = parameter("lock_yaw_to_vehicle").as_bool();
+    continuous_yaw_ = parameter("continuous_yaw").as_bool();
+    if (changed({"setpoint_shaping"})) {
+      setpoint_shaping_ = setpoint_shaping;
+    }
+    // The profile continues from the current orientation, in the frame of the new goals
+    if (setpoint_shaping_ && shaper_.initialized()) {
+      shaper_.reset(measuredGimbalMove(driver_state_.load()));
     }
+  }
+  if (changed({"setpoint_shaping", "shaper_max_velocity", "shaper_max_acceleration",
+      "shaper_max_jerk", "tilt_axis_input_mode", "roll_axis_input_mode",
+      "pan_axis_input_mode", "goal_push_rate"}) && setpoint_shaping)
+  {
+    shaper_.setLimits(limits);
+  }
+  if (changed({"goal_deadband", "goal_deadband_hysteresis", "goal_keepalive_period"})) {
+    setpoint_filter_.configure(filter_config);
+  }
+  return result;
 }
 
 void GremsyDriver::declareParameters()
 {
   this->declare_parameter(
     "device_id", 0,
-    getParamDescriptor(
+    readOnly(getParamDescriptor(
       "device_id", "Device id- 0: MIO, 1: S1, 2: T3V3, 3: T7",
-      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 0, 3));
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 0, NUM_OF_MODELS - 1)));
 
   this->declare_parameter(
     "com_port", "/dev/ttyUSB0",
-    getParamDescriptor(
+    readOnly(getParamDescriptor(
       "com_port", "Serial device for the gimbal connection",
-      rcl_interfaces::msg::ParameterType::PARAMETER_STRING));
+      rcl_interfaces::msg::ParameterType::PARAMETER_STRING)));
 
   this->declare_parameter(
     "baudrate", 115200,
-    getParamDescriptor(
-      "baudrate", "Baudrate for the gimbal connection",
-      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER));
+    readOnly(getParamDescriptor(
+      "baudrate", "Baudrate for the gimbal connection, 9600 to 921600",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER)));
+
+  this->declare_parameter(
+    "baudrate_autoprobe", false,
+    readOnly(getParamDescriptor(
+      "baudrate_autoprobe",
+      "Look for the gimbal heartbeats at baudrate, then at the baudrate_candidates",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "baudrate_candidates", std::vector<int64_t>{115200, 921600, 460800, 230400, 57600},
+    readOnly(getParamDescriptor(
+      "baudrate_candidates",
+      "Baudrates tried in order by the autoprobe after the configured one",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY)));
+
+  this->declare_parameter(
+    "baudrate_probe_timeout", 1.5,
+    readOnly(getParamDescriptor(
+      "baudrate_probe_timeout",
+      "Time in seconds to wait for a heartbeat at each baudrate",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.1, 10.0, 0.0)));
+
+  this->declare_parameter(
+    "startup_timeout", 0.0,
+    readOnly(getParamDescriptor(
+      "startup_timeout",
+      "Time in seconds to wait for the gimbal motors to turn on before failing, 0 waits forever",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.0, 600.0, 0.0)));
 
   this->declare_parameter(
     "state_poll_rate", 50.0,
@@ -322,6 +1143,335 @@ void GremsyDriver::declareParameters()
       "Uses the yaw relative to the gimbal mount to prevent drift issues. Only a light stabilization is applied.",
       rcl_interfaces::msg::ParameterType::PARAMETER_BOOL));
 
+  this->declare_parameter(
+    "continuous_yaw", false,
+    getParamDescriptor(
+      "continuous_yaw",
+      "Track the multi-turn pan angle and move to yaw goals the shortest reachable way",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL));
+
+  this->declare_parameter(
+    "legacy_state_topics", true,
+    readOnly(getParamDescriptor(
+      "legacy_state_topics",
+      "Publish ~/imu, ~/encoder and ~/mount_orientation_* besides ~/state",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "imu_accel_scale", 0.0,
+    readOnly(getParamDescriptor(
+      "imu_accel_scale",
+      "Raw accelerometer scale in m/s^2 per count, 0 uses the assumed device default",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_gyro_scale", 0.0,
+    readOnly(getParamDescriptor(
+      "imu_gyro_scale",
+      "Raw gyro scale in rad/s per count, 0 uses the assumed device default",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_accel_stddev", 0.05,
+    readOnly(getParamDescriptor(
+      "imu_accel_stddev",
+      "Standard deviation of the acceleration in m/s^2, used for the covariance",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_gyro_stddev", 0.005,
+    readOnly(getParamDescriptor(
+      "imu_gyro_stddev",
+      "Standard deviation of the angular velocity in rad/s, used for the covariance",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_gyro_bias_estimation", true,
+    readOnly(getParamDescriptor(
+      "imu_gyro_bias_estimation",
+      "Estimate and remove the gyro bias while the gimbal is stationary",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "imu_stationary_gyro_threshold", 0.05,
+    readOnly(getParamDescriptor(
+      "imu_stationary_gyro_threshold",
+      "Maximum raw angular velocity in rad/s to be considered stationary",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_stationary_accel_threshold", 0.5,
+    readOnly(getParamDescriptor(
+      "imu_stationary_accel_threshold",
+      "Maximum deviation of the acceleration from gravity in m/s^2 to be considered stationary",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_stationary_time", 1.0,
+    readOnly(getParamDescriptor(
+      "imu_stationary_time",
+      "Time in seconds the gimbal has to be stationary before the gyro bias is updated",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_gyro_bias_time_constant", 10.0,
+    readOnly(getParamDescriptor(
+      "imu_gyro_bias_time_constant",
+      "Time constant in seconds of the gyro bias estimate",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "imu_max_gyro_bias", 0.02,
+    readOnly(getParamDescriptor(
+      "imu_max_gyro_bias",
+      "Maximum magnitude of the gyro bias estimate in rad/s",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "attitude_filter", false,
+    readOnly(getParamDescriptor(
+      "attitude_filter",
+      "Fuse the gyro with the mount orientation and publish it for each new IMU sample polled",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "attitude_filter_time_constant", 0.5,
+    readOnly(getParamDescriptor(
+      "attitude_filter_time_constant",
+      "Time constant in seconds of the correction towards the mount orientation",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "attitude_filter_gyro_signs", std::vector<double>{1.0, 1.0, -1.0},
+    readOnly(getParamDescriptor(
+      "attitude_filter_gyro_signs",
+      "Signs mapping the gyro axes (x, y, z) to the axes of the published orientation",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY)));
+
+  this->declare_parameter(
+    "diagnostics_rate_tolerance", 0.1,
+    readOnly(getParamDescriptor(
+      "diagnostics_rate_tolerance",
+      "Allowed relative deviation of the state and goal rates before a warning",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "diagnostics_heartbeat_warn_age", 1.0,
+    readOnly(getParamDescriptor(
+      "diagnostics_heartbeat_warn_age",
+      "Age of the last heartbeat in seconds at which the link is reported as warning",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "diagnostics_heartbeat_error_age", 3.0,
+    readOnly(getParamDescriptor(
+      "diagnostics_heartbeat_error_age",
+      "Age of the last heartbeat in seconds at which the link is reported as error",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "diagnostics_max_late_goal_ratio", 0.01,
+    readOnly(getParamDescriptor(
+      "diagnostics_max_late_goal_ratio",
+      "Fraction of goal ticks starting late at which a warning is reported",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "diagnostics_time_offset_jitter_warn", 0.02,
+    readOnly(getParamDescriptor(
+      "diagnostics_time_offset_jitter_warn",
+      "Jitter of the gimbal to host clock offset in seconds at which a warning is reported",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE)));
+
+  this->declare_parameter(
+    "diagnostics_max_link_utilization", 0.8,
+    readOnly(getParamDescriptor(
+      "diagnostics_max_link_utilization",
+      "Fraction of the serial link capacity used in either direction at which a warning is reported",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.0, 1.0, 0.0)));
+
+  this->declare_parameter(
+    "setpoint_shaping", false,
+    getParamDescriptor(
+      "setpoint_shaping",
+      "Move to each new goal with a jerk-limited profile instead of a single step",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL));
+
+  this->declare_parameter(
+    "shaper_max_velocity", std::vector<double>{90.0, 90.0, 90.0},
+    getParamDescriptor(
+      "shaper_max_velocity",
+      "Setpoint shaper velocity limits in deg/s (roll, tilt, pan), keep them below the rated speed of the gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY));
+
+  this->declare_parameter(
+    "shaper_max_acceleration", std::vector<double>{180.0, 180.0, 180.0},
+    getParamDescriptor(
+      "shaper_max_acceleration",
+      "Setpoint shaper acceleration limits in deg/s^2 (roll, tilt, pan)",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY));
+
+  this->declare_parameter(
+    "shaper_max_jerk", std::vector<double>{720.0, 720.0, 720.0},
+    getParamDescriptor(
+      "shaper_max_jerk",
+      "Setpoint shaper jerk limits in deg/s^3 (roll, tilt, pan)",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY));
+
+  this->declare_parameter(
+    "goal_deadband", std::vector<double>{0.0, 0.0, 0.0},
+    getParamDescriptor(
+      "goal_deadband",
+      "Setpoints closer than this to the last sent one are not sent, in degrees (roll, tilt, pan)",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE_ARRAY));
+
+  this->declare_parameter(
+    "goal_deadband_hysteresis", 0.5,
+    getParamDescriptor(
+      "goal_deadband_hysteresis",
+      "Fraction of the deadband removed while the goal is moving",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.0, 1.0, 0.0));
+
+  this->declare_parameter(
+    "goal_keepalive_period", 0.0,
+    getParamDescriptor(
+      "goal_keepalive_period",
+      "Resend the latest setpoint after this many seconds without commands, 0 disables it",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.0, 60.0, 0.0));
+
+  this->declare_parameter(
+    "command_ack_timeout", 0.2,
+    readOnly(getParamDescriptor(
+      "command_ack_timeout",
+      "Time in seconds to wait for the acknowledgement of a configuration command before resending it",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.01, 5.0, 0.0)));
+
+  this->declare_parameter(
+    "command_max_retries", 3,
+    readOnly(getParamDescriptor(
+      "command_max_retries",
+      "Number of resends of an unacknowledged configuration command",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 0, 10)));
+
+  this->declare_parameter(
+    "adaptive_poll_rate", false,
+    getParamDescriptor(
+      "adaptive_poll_rate",
+      "Follow the rate of the gimbal streams with the state poll rate, starting at state_poll_rate",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL));
+
+  this->declare_parameter(
+    "adaptive_poll_min_rate", 10.0,
+    getParamDescriptor(
+      "adaptive_poll_min_rate",
+      "Lowest state poll rate in Hz of the adaptive poll rate",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 1.0, 1000.0, 0.0));
+
+  this->declare_parameter(
+    "adaptive_poll_max_rate", 200.0,
+    getParamDescriptor(
+      "adaptive_poll_max_rate",
+      "Highest state poll rate in Hz of the adaptive poll rate",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 1.0, 1000.0, 0.0));
+
+  this->declare_parameter(
+    "adaptive_poll_margin", 1.25,
+    getParamDescriptor(
+      "adaptive_poll_margin",
+      "State poll rate relative to the fastest stream, trading CPU for latency",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 1.0, 4.0, 0.0));
+
+  this->declare_parameter(
+    "state_publisher_thread", false,
+    readOnly(getParamDescriptor(
+      "state_publisher_thread",
+      "Poll and publish the gimbal state from a dedicated thread instead of an executor timer",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "state_publisher_thread_priority", 0,
+    readOnly(getParamDescriptor(
+      "state_publisher_thread_priority",
+      "SCHED_FIFO priority of the state publisher thread, 0 keeps the default scheduling",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 0, 99)));
+
+  this->declare_parameter(
+    "state_publisher_thread_cpus", std::vector<int64_t>{},
+    readOnly(getParamDescriptor(
+      "state_publisher_thread_cpus",
+      "CPUs the state publisher thread may run on, empty for any",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY)));
+
+  this->declare_parameter(
+    "request_stream_rates", false,
+    readOnly(getParamDescriptor(
+      "request_stream_rates",
+      "Request the rate of each stream from the gimbal with MAV_CMD_SET_MESSAGE_INTERVAL",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "imu_stream_rate", 0.0,
+    getParamDescriptor(
+      "imu_stream_rate",
+      "Rate in Hz of the raw IMU stream, 0 is the state_poll_rate, negative leaves it to the gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE));
+
+  this->declare_parameter(
+    "encoder_stream_rate", 0.0,
+    getParamDescriptor(
+      "encoder_stream_rate",
+      "Rate in Hz of the mount status stream, 0 is the state_poll_rate, negative leaves it to the gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE));
+
+  this->declare_parameter(
+    "mount_orientation_stream_rate", 0.0,
+    getParamDescriptor(
+      "mount_orientation_stream_rate",
+      "Rate in Hz of the mount orientation stream, 0 is the state_poll_rate, negative leaves it to the gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE));
+
+  this->declare_parameter(
+    "stream_idle_rate", 1.0,
+    getParamDescriptor(
+      "stream_idle_rate",
+      "Rate in Hz of the streams without subscribers, negative keeps their configured rates",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE));
+
+  this->declare_parameter(
+    "link_capture", false,
+    readOnly(getParamDescriptor(
+      "link_capture",
+      "Record the raw bytes of the serial link to rotating capture files",
+      rcl_interfaces::msg::ParameterType::PARAMETER_BOOL)));
+
+  this->declare_parameter(
+    "link_capture_directory", "/tmp/ros2_gremsy_capture",
+    readOnly(getParamDescriptor(
+      "link_capture_directory",
+      "Directory of the capture files, created if missing",
+      rcl_interfaces::msg::ParameterType::PARAMETER_STRING)));
+
+  this->declare_parameter(
+    "link_capture_file_size", 64,
+    readOnly(getParamDescriptor(
+      "link_capture_file_size",
+      "Size in MiB after which a new capture file is started",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 1, 4096)));
+
+  this->declare_parameter(
+    "link_capture_max_files", 8,
+    readOnly(getParamDescriptor(
+      "link_capture_max_files",
+      "Number of capture files kept, the oldest ones are deleted, 0 keeps all",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 0, 10000)));
+
+  this->declare_parameter(
+    "link_capture_buffer_size", 4096,
+    readOnly(getParamDescriptor(
+      "link_capture_buffer_size",
+      "Size in KiB of the buffer between the link and the capture writer",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 64, 1048576)));
+
 }
 
 
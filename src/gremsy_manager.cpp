@@ -0,0 +1,141 @@
+#include <exception>
+#include <future>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ros2_gremsy/gremsy_manager.hpp"
+
+namespace ros2_gremsy
+{
+
+GremsyManager::GremsyManager(const rclcpp::NodeOptions & options)
+: Node("gremsy_manager", options)
+{
+  declareParameters();
+  executor_threads_ = this->get_parameter("executor_threads").as_int();
+  std::vector<std::string> com_ports = this->get_parameter("com_ports").as_string_array();
+  std::vector<int64_t> baudrates = this->get_parameter("baudrates").as_integer_array();
+  std::vector<int64_t> device_ids = this->get_parameter("device_ids").as_integer_array();
+  std::vector<std::string> namespaces = this->get_parameter("namespaces").as_string_array();
+
+  if (baudrates.size() != com_ports.size() || device_ids.size() != com_ports.size() ||
+    namespaces.size() != com_ports.size())
+  {
+    RCLCPP_FATAL(this->get_logger(), "com_ports, baudrates, device_ids and namespaces "
+      "must have the same number of entries");
+    throw std::invalid_argument("Mismatching gimbal parameter lists");
+  }
+
+  // The drivers all have the node name of the standalone driver, so the namespace is what
+  // tells their topics, services and parameters apart
+  std::set<std::string> unique_namespaces;
+  for (std::string & node_namespace : namespaces) {
+    if (node_namespace.rfind("/", 0) != 0) {
+      node_namespace = "/" + node_namespace;
+    }
+    if (!unique_namespaces.insert(node_namespace).second) {
+      RCLCPP_FATAL(this->get_logger(), "The namespace '%s' is used by more than one gimbal",
+        node_namespace.c_str());
+      throw std::invalid_argument("Duplicate gimbal namespace");
+    }
+  }
+
+  const std::string params_file = this->get_parameter("driver_params_file").as_string();
+  const double startup_timeout = this->get_parameter("driver_startup_timeout").as_double();
+
+  // The drivers wait for their gimbal to turn on, so they are started concurrently, and a
+  // gimbal that does not answer within the startup timeout does not hold up the others
+  std::vector<std::future<std::shared_ptr<GremsyDriver>>> starting;
+  for (size_t i = 0; i < com_ports.size(); ++i) {
+    RCLCPP_INFO(this->get_logger(), "Starting gimbal %zu on %s in namespace '%s'",
+      i, com_ports[i].c_str(), namespaces[i].c_str());
+
+    // The command line arguments of the process are not applied to the drivers, each one
+    // gets its own namespace, and the parameters of the driver parameter file. The overrides
+    // below take precedence over the file for the connection settings.
+    std::vector<std::string> arguments = {"--ros-args", "-r", "__ns:=" + namespaces[i]};
+    if (!params_file.empty()) {
+      arguments.insert(arguments.end(), {"--params-file", params_file});
+    }
+    rclcpp::NodeOptions driver_options;
+    driver_options.use_global_arguments(false);
+    driver_options.arguments(arguments);
+    driver_options.parameter_overrides(
+    {
+      rclcpp::Parameter("com_port", com_ports[i]),
+      rclcpp::Parameter("baudrate", baudrates[i]),
+      rclcpp::Parameter("device_id", device_ids[i]),
+      rclcpp::Parameter("startup_timeout", startup_timeout),
+    });
+    starting.push_back(
+      std::async(
+        std::launch::async, [driver_options, com_port = com_ports[i]]() {
+          return std::make_shared<GremsyDriver>(driver_options, com_port);
+        }));
+  }
+
+  for (size_t i = 0; i < starting.size(); ++i) {
+    try {
+      drivers_.push_back(starting[i].get());
+    } catch (const std::exception & error) {
+      RCLCPP_ERROR(this->get_logger(), "Gimbal %zu on %s failed to start: %s",
+        i, com_ports[i].c_str(), error.what());
+    }
+  }
+  if (drivers_.empty()) {
+    RCLCPP_FATAL(this->get_logger(), "None of the gimbals started");
+    throw std::runtime_error("No gimbal started");
+  }
+}
+
+void GremsyManager::declareParameters()
+{
+  this->declare_parameter(
+    "com_ports", std::vector<std::string>{"/dev/ttyUSB0"},
+    getParamDescriptor(
+      "com_ports", "Serial devices of the gimbals, one per gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY));
+
+  this->declare_parameter(
+    "baudrates", std::vector<int64_t>{115200},
+    getParamDescriptor(
+      "baudrates", "Baudrates of the gimbal connections, one per gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY));
+
+  this->declare_parameter(
+    "device_ids", std::vector<int64_t>{0},
+    getParamDescriptor(
+      "device_ids", "Device ids of the gimbals, one per gimbal. 0: MIO, 1: S1, 2: T3V3, 3: T7",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER_ARRAY));
+
+  this->declare_parameter(
+    "namespaces", std::vector<std::string>{"gimbal0"},
+    getParamDescriptor(
+      "namespaces", "Namespaces of the gimbal nodes, one per gimbal",
+      rcl_interfaces::msg::ParameterType::PARAMETER_STRING_ARRAY));
+
+  this->declare_parameter(
+    "driver_params_file", "",
+    getParamDescriptor(
+      "driver_params_file",
+      "Parameter file applied to every driver, the command line arguments are not",
+      rcl_interfaces::msg::ParameterType::PARAMETER_STRING));
+
+  this->declare_parameter(
+    "driver_startup_timeout", 30.0,
+    getParamDescriptor(
+      "driver_startup_timeout",
+      "Time in seconds each gimbal has to turn on, the gimbals that do not are skipped",
+      rcl_interfaces::msg::ParameterType::PARAMETER_DOUBLE, 0.0, 600.0, 0.0));
+
+  this->declare_parameter(
+    "executor_threads", 2,
+    getParamDescriptor(
+      "executor_threads", "Number of executor threads shared by all gimbals",
+      rcl_interfaces::msg::ParameterType::PARAMETER_INTEGER, 1, 16));
+}
+
+}  // namespace ros2_gremsy
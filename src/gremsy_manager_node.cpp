@@ -0,0 +1,25 @@
+
+#include "ros2_gremsy/gremsy_manager.hpp"
+using namespace ros2_gremsy;
+
+int main(int argc, char * argv[])
+{
+    rclcpp::init(argc, argv);
+
+    std::cout << "ROS2 Gremsy multi-gimbal driver node." << std::endl;
+    rclcpp::NodeOptions options;
+    auto gremsyManager = std::make_shared<GremsyManager>(options);
+
+    // All gimbals share the same executor threads
+    rclcpp::executors::MultiThreadedExecutor exec(
+      rclcpp::ExecutorOptions(), gremsyManager->executorThreads());
+    exec.add_node(gremsyManager);
+    for (const auto & gremsyDriver : gremsyManager->drivers()) {
+        exec.add_node(gremsyDriver);
+    }
+    exec.spin();
+
+    rclcpp::shutdown();
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ros2_gremsy/msg/gimbal_state.hpp"
+#include "ros2_gremsy/gremsy.hpp"
+#include "ros2_gremsy/link_replay.hpp"
+#include "ros2_gremsy/link_tap.hpp"
+
+using namespace ros2_gremsy;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+void printUsage()
+{
+  std::fprintf(
+    stderr,
+    "Usage: gremsy_replay [--rate RATE] [--loop] FILE.cap... [--ros-args ...]\n"
+    "Runs the driver on the received side of link captures, without a gimbal.\n"
+    "  --rate RATE  Speed relative to the recorded timing, 0 is as fast as possible (default)\n"
+    "  --loop       Start again with the first file after the last one, until interrupted\n"
+    "The startup of the driver is always played at the recorded timing.\n");
+}
+
+double processCpuTime()
+{
+  timespec time{};
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return static_cast<double>(time.tv_sec) + 1e-9 * static_cast<double>(time.tv_nsec);
+}
+
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+
+  LinkReplay::Config replay_config;
+  double rate = 0.0;
+  const std::vector<std::string> args = rclcpp::remove_ros_arguments(argc, argv);
+  for (std::size_t i = 1; i < args.size(); ++i) {
+    if (args[i] == "--rate" && i + 1 < args.size()) {
+      try {
+        rate = std::stod(args[++i]);
+      } catch (const std::exception &) {
+        rate = -1.0;
+      }
+      if (rate < 0.0) {
+        printUsage();
+        return 1;
+      }
+    } else if (args[i] == "--loop") {
+      replay_config.loop = true;
+    } else if (args[i].rfind("--", 0) == 0) {
+      printUsage();
+      return 1;
+    } else {
+      replay_config.files.push_back(args[i]);
+    }
+  }
+  if (replay_config.files.empty()) {
+    printUsage();
+    return 1;
+  }
+
+  // gSDK opens the slave side as its serial port. It is held open here as well, so that
+  // the bytes played before gSDK opens it are kept.
+  std::string slave_path;
+  const int pty_fd = LinkTap::openPseudoTerminal(slave_path);
+  const int slave_fd = open(slave_path.c_str(), O_RDWR | O_NOCTTY);
+  replay_config.rate = 1.0;
+  auto replay = std::make_unique<LinkReplay>(pty_fd, replay_config);
+
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({{"com_port", slave_path}});
+  auto driver = std::make_shared<GremsyDriver>(options, slave_path);
+
+  // Count the published state the way a subscriber sees it
+  auto counter = std::make_shared<rclcpp::Node>("gremsy_replay");
+  std::atomic<uint64_t> imu_messages{0};
+  std::atomic<uint64_t> encoder_messages{0};
+  std::atomic<uint64_t> state_messages{0};
+  const std::string topic_prefix = driver->get_fully_qualified_name();
+  auto imu_sub = counter->create_subscription<sensor_msgs::msg::Imu>(
+    topic_prefix + "/imu", rclcpp::SensorDataQoS(),
+    [&imu_messages](sensor_msgs::msg::Imu::ConstSharedPtr) {imu_messages++;});
+  auto encoder_sub = counter->create_subscription<geometry_msgs::msg::Vector3Stamped>(
+    topic_prefix + "/encoder", rclcpp::SensorDataQoS(),
+    [&encoder_messages](geometry_msgs::msg::Vector3Stamped::ConstSharedPtr) {encoder_messages++;});
+  auto state_sub = counter->create_subscription<msg::GimbalState>(
+    topic_prefix + "/state", rclcpp::SensorDataQoS(),
+    [&state_messages](msg::GimbalState::ConstSharedPtr) {state_messages++;});
+
+  rclcpp::executors::MultiThreadedExecutor exec;
+  exec.add_node(driver);
+  exec.add_node(counter);
+  std::thread spinner([&exec]() {exec.spin();});
+
+  // Measure from the end of the startup, at the requested rate
+  const LinkReplay::Stats start = replay->stats();
+  const auto start_time = std::chrono::steady_clock::now();
+  const double start_cpu = processCpuTime();
+  imu_messages = 0;
+  encoder_messages = 0;
+  state_messages = 0;
+  replay->setRate(rate);
+
+  while (rclcpp::ok() && !replay->finished()) {
+    std::this_thread::sleep_for(10ms);
+  }
+
+  const LinkReplay::Stats end = replay->stats();
+  const double wall = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start_time).count();
+  const double cpu = processCpuTime() - start_cpu;
+  const uint64_t frames = end.frames - start.frames;
+  std::printf(
+    "Replayed %lu records, %lu bytes, %lu MAVLink frames in %.3f s\n",
+    static_cast<unsigned long>(end.records - start.records),
+    static_cast<unsigned long>(end.bytes - start.bytes), static_cast<unsigned long>(frames), wall);
+  if (wall > 0.0 && frames > 0) {
+    std::printf("Frames fed:          %.0f frames/s\n", frames / wall);
+    std::printf("IMU published:       %.1f messages/s\n", imu_messages / wall);
+    std::printf("Encoder published:   %.1f messages/s\n", encoder_messages / wall);
+    std::printf("State published:     %.1f messages/s\n", state_messages / wall);
+    std::printf("CPU per frame:       %.2f us, replay thread included\n", 1e6 * cpu / frames);
+  }
+
+  exec.cancel();
+  spinner.join();
+  replay.reset();
+  if (slave_fd >= 0) {
+    close(slave_fd);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
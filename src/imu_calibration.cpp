@@ -0,0 +1,80 @@
+#include <cmath>
+
+#include "ros2_gremsy/imu_calibration.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+constexpr double kGravity = 9.80665;
+/// Samples further apart than this do not update the bias, e.g. after a link outage
+constexpr double kMaxSampleInterval = 0.5;
+}  // namespace
+
+void ImuCalibration::configure(const Config & config)
+{
+  config_ = config;
+}
+
+void ImuCalibration::apply(const mavlink_raw_imu_t & raw, sensor_msgs::msg::Imu & imu)
+{
+  const Eigen::Vector3d accel =
+    config_.accel_scale * Eigen::Vector3d(raw.xacc, raw.yacc, raw.zacc);
+  const Eigen::Vector3d gyro =
+    config_.gyro_scale * Eigen::Vector3d(raw.xgyro, raw.ygyro, raw.zgyro);
+
+  // The same sample can be read on several ticks, only new ones update the estimate
+  if (raw.time_usec != last_sample_usec_) {
+    const double dt = last_sample_usec_ == 0 || raw.time_usec < last_sample_usec_ ?
+      0.0 : 1e-6 * static_cast<double>(raw.time_usec - last_sample_usec_);
+    last_sample_usec_ = raw.time_usec;
+    update(accel, gyro, dt);
+  }
+
+  imu.linear_acceleration.x = accel.x();
+  imu.linear_acceleration.y = accel.y();
+  imu.linear_acceleration.z = accel.z();
+
+  const Eigen::Vector3d angular_velocity = gyro - gyro_bias_;
+  imu.angular_velocity.x = angular_velocity.x();
+  imu.angular_velocity.y = angular_velocity.y();
+  imu.angular_velocity.z = angular_velocity.z();
+
+  const double accel_variance = config_.accel_stddev * config_.accel_stddev;
+  const double gyro_variance = config_.gyro_stddev * config_.gyro_stddev;
+  for (int i = 0; i < 9; ++i) {
+    imu.linear_acceleration_covariance[i] = i % 4 == 0 ? accel_variance : 0.0;
+    imu.angular_velocity_covariance[i] = i % 4 == 0 ? gyro_variance : 0.0;
+    imu.orientation_covariance[i] = 0.0;
+  }
+  // No orientation estimate in this message
+  imu.orientation_covariance[0] = -1.0;
+}
+
+Eigen::Vector3d ImuCalibration::angularVelocity(const mavlink_raw_imu_t & raw) const
+{
+  return config_.gyro_scale * Eigen::Vector3d(raw.xgyro, raw.ygyro, raw.zgyro) - gyro_bias_;
+}
+
+void ImuCalibration::update(const Eigen::Vector3d & accel, const Eigen::Vector3d & gyro, double dt)
+{
+  if (!config_.estimate_gyro_bias || dt <= 0.0 || dt > kMaxSampleInterval) {
+    return;
+  }
+  const bool still =
+    gyro.norm() < config_.stationary_gyro_threshold &&
+    std::fabs(accel.norm() - kGravity) < config_.stationary_accel_threshold;
+  stationary_for_ = still ? stationary_for_ + dt : 0.0;
+
+  if (stationary()) {
+    const double alpha = dt / (config_.bias_time_constant + dt);
+    gyro_bias_ += alpha * (gyro - gyro_bias_);
+    const double bias_norm = gyro_bias_.norm();
+    if (bias_norm > config_.max_gyro_bias) {
+      gyro_bias_ *= config_.max_gyro_bias / bias_norm;
+    }
+  }
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,116 @@
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#include "ros2_gremsy/link_capture.hpp"
+
+namespace ros2_gremsy
+{
+
+LinkCapture::LinkCapture(const Config & config)
+: config_(config), ring_(config.buffer_size)
+{
+  std::error_code error;
+  std::filesystem::create_directories(config_.directory, error);
+  if (error) {
+    throw std::runtime_error(
+      "Cannot create the capture directory " + config_.directory + ": " + error.message());
+  }
+
+  char start_time[32];
+  const std::time_t now = std::time(nullptr);
+  std::tm local_time{};
+  localtime_r(&now, &local_time);
+  std::strftime(start_time, sizeof(start_time), "%Y%m%d-%H%M%S", &local_time);
+  start_time_ = start_time;
+
+  openFile();
+  if (!file_) {
+    throw std::runtime_error(
+      "Cannot open a capture file in " + config_.directory + ": " + std::strerror(errno));
+  }
+  writer_ = std::thread(&LinkCapture::run, this);
+}
+
+LinkCapture::~LinkCapture()
+{
+  running_ = false;
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  flush();
+  if (file_) {
+    std::fclose(file_);
+  }
+}
+
+LinkCapture::Stats LinkCapture::stats() const
+{
+  Stats stats;
+  stats.records = records_.load(std::memory_order_relaxed);
+  stats.bytes = bytes_.load(std::memory_order_relaxed);
+  stats.dropped_records = dropped_records_.load(std::memory_order_relaxed);
+  stats.dropped_bytes = dropped_bytes_.load(std::memory_order_relaxed);
+  stats.files = files_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void LinkCapture::run()
+{
+  while (running_) {
+    std::this_thread::sleep_for(config_.flush_period);
+    flush();
+  }
+}
+
+void LinkCapture::flush()
+{
+  if (!file_) {
+    return;
+  }
+  ring_.read(
+    [this](const uint8_t * data, std::size_t size) {
+      file_size_ += std::fwrite(data, 1, size, file_);
+    });
+  std::fflush(file_);
+  // Records are never split, a file is only rotated between flushes
+  if (config_.max_file_size > 0 && file_size_ >= config_.max_file_size) {
+    std::fclose(file_);
+    file_ = nullptr;
+    openFile();
+  }
+}
+
+void LinkCapture::openFile()
+{
+  char sequence[16];
+  std::snprintf(
+    sequence, sizeof(sequence), "%04lu",
+    static_cast<unsigned long>(files_.load(std::memory_order_relaxed)));
+  const std::string path = config_.directory + "/" + config_.prefix + "_" + start_time_ + "_" +
+    sequence + ".cap";
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    // Without a file the ring fills up and the chunks are counted as dropped
+    return;
+  }
+  file_size_ = std::fwrite(CAPTURE_FILE_MAGIC, 1, sizeof(CAPTURE_FILE_MAGIC), file_);
+  file_size_ += std::fwrite(&CAPTURE_FILE_VERSION, 1, sizeof(CAPTURE_FILE_VERSION), file_);
+  files_.fetch_add(1, std::memory_order_relaxed);
+  file_paths_.push_back(path);
+  removeOldFiles();
+}
+
+void LinkCapture::removeOldFiles()
+{
+  while (config_.max_files > 0 && file_paths_.size() > config_.max_files) {
+    std::remove(file_paths_.front().c_str());
+    file_paths_.pop_front();
+  }
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,195 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "ros2_gremsy/link_replay.hpp"
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Largest record accepted, far above any chunk read from a serial port
+constexpr uint32_t kMaxRecordLength = 1u << 20;
+}  // namespace
+
+CaptureReader::CaptureReader(const std::string & path)
+: file_(std::fopen(path.c_str(), "rb"))
+{
+  if (!file_) {
+    throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+  }
+  char magic[sizeof(CAPTURE_FILE_MAGIC)];
+  uint32_t version = 0;
+  if (std::fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+    std::memcmp(magic, CAPTURE_FILE_MAGIC, sizeof(magic)) != 0 ||
+    std::fread(&version, 1, sizeof(version), file_) != sizeof(version))
+  {
+    std::fclose(file_);
+    throw std::runtime_error(path + " is not a link capture file");
+  }
+  if (version != CAPTURE_FILE_VERSION) {
+    std::fclose(file_);
+    throw std::runtime_error(
+      path + " has the unsupported capture format version " + std::to_string(version));
+  }
+}
+
+CaptureReader::~CaptureReader()
+{
+  std::fclose(file_);
+}
+
+bool CaptureReader::next(CaptureRecordHeader & header, std::vector<uint8_t> & data)
+{
+  if (std::fread(&header, 1, sizeof(header), file_) != sizeof(header) ||
+    header.length > kMaxRecordLength)
+  {
+    return false;
+  }
+  data.resize(header.length);
+  return std::fread(data.data(), 1, header.length, file_) == header.length;
+}
+
+LinkReplay::LinkReplay(int fd, const Config & config)
+: fd_(fd), config_(config), rate_(config.rate)
+{
+  // Check all files up front, instead of failing in the middle of the replay
+  for (const std::string & path : config_.files) {
+    CaptureReader reader(path);
+  }
+  if (pipe(stop_fd_) != 0) {
+    throw std::runtime_error(std::string("Cannot create the replay pipe: ") + std::strerror(errno));
+  }
+  fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+  thread_ = std::thread(&LinkReplay::run, this);
+}
+
+LinkReplay::~LinkReplay()
+{
+  const uint8_t stop = 1;
+  static_cast<void>(::write(stop_fd_[1], &stop, 1));
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(stop_fd_[0]);
+  close(stop_fd_[1]);
+  close(fd_);
+}
+
+LinkReplay::Stats LinkReplay::stats() const
+{
+  Stats stats;
+  stats.records = records_.load(std::memory_order_relaxed);
+  stats.bytes = bytes_.load(std::memory_order_relaxed);
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void LinkReplay::run()
+{
+  bool playing = true;
+  do {
+    for (const std::string & path : config_.files) {
+      playing = play(path);
+      if (!playing) {
+        break;
+      }
+    }
+    // Timestamps start over with the next pass
+    anchor_rate_ = -1.0;
+  } while (playing && config_.loop);
+  finished_.store(true, std::memory_order_release);
+  // Keep discarding what gSDK writes until stopped
+  while (playing && wait(-1, false)) {
+  }
+}
+
+bool LinkReplay::play(const std::string & path)
+{
+  CaptureReader reader(path);
+  CaptureRecordHeader header;
+  std::vector<uint8_t> data;
+  mavlink_message_t message;
+  mavlink_status_t status;
+  while (reader.next(header, data)) {
+    if (header.direction != LinkDirection::RX) {
+      continue;
+    }
+
+    const double rate = rate_.load(std::memory_order_relaxed);
+    if (rate != anchor_rate_ || header.timestamp_ns < anchor_record_ns_) {
+      anchor_rate_ = rate;
+      anchor_record_ns_ = header.timestamp_ns;
+      anchor_time_ = LinkCapture::Clock::now();
+    }
+    if (rate > 0.0) {
+      const auto due = anchor_time_ + std::chrono::nanoseconds(
+        static_cast<int64_t>(static_cast<double>(header.timestamp_ns - anchor_record_ns_) / rate));
+      for (auto now = LinkCapture::Clock::now(); now < due; now = LinkCapture::Clock::now()) {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(due - now).count();
+        if (!wait(static_cast<int>(remaining), false)) {
+          return false;
+        }
+      }
+    }
+
+    if (!writeAll(data.data(), data.size())) {
+      return false;
+    }
+    uint64_t frames = 0;
+    for (const uint8_t byte : data) {
+      frames += mavlink_parse_char(MAVLINK_COMM_2, byte, &message, &status);
+    }
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(data.size(), std::memory_order_relaxed);
+    frames_.fetch_add(frames, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+bool LinkReplay::wait(int timeout_ms, bool writable)
+{
+  pollfd fds[2] = {
+    {fd_, static_cast<short>(POLLIN | (writable ? POLLOUT : 0)), 0},
+    {stop_fd_[0], POLLIN, 0},
+  };
+  if (poll(fds, 2, timeout_ms) < 0) {
+    return errno == EINTR;
+  }
+  if (fds[1].revents != 0) {
+    return false;
+  }
+  if ((fds[0].revents & POLLIN) != 0) {
+    uint8_t discarded[1024];
+    while (::read(fd_, discarded, sizeof(discarded)) > 0) {
+    }
+  } else if ((fds[0].revents & POLLHUP) != 0) {
+    // The slave side is not open, nothing to discard until it is
+    usleep(10000);
+  }
+  return true;
+}
+
+bool LinkReplay::writeAll(const uint8_t * data, std::size_t size)
+{
+  while (size > 0) {
+    const ssize_t written = ::write(fd_, data, size);
+    if (written > 0) {
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    } else if (written < 0 && errno != EAGAIN && errno != EINTR && errno != EIO) {
+      return false;
+    } else if (!wait(100, true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace ros2_gremsy
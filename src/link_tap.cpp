@@ -0,0 +1,253 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "ros2_gremsy/link_tap.hpp"
+#include "ros2_gremsy/tracing.hpp"
+
+#include "ros2_gremsy/mavlink_parser.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+constexpr std::size_t kChunkSize = 4096;
+
+speed_t toSpeed(int baudrate)
+{
+  switch (baudrate) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 576000: return B576000;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    default:
+      throw std::runtime_error("Unsupported baudrate " + std::to_string(baudrate));
+  }
+}
+
+void makeRaw(int fd, const std::string & name)
+{
+  termios config{};
+  if (tcgetattr(fd, &config) != 0) {
+    throw std::runtime_error("Cannot read the settings of " + name + ": " + std::strerror(errno));
+  }
+  cfmakeraw(&config);
+  config.c_cflag |= CLOCAL | CREAD;
+  config.c_cc[VMIN] = 1;
+  config.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &config) != 0) {
+    throw std::runtime_error("Cannot configure " + name + ": " + std::strerror(errno));
+  }
+}
+
+bool writeAll(int fd, const uint8_t * data, std::size_t size)
+{
+  while (size > 0) {
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+}  // namespace
+
+LinkTap::LinkTap(int device_fd, int pty_fd, LinkCapture * capture, StopCallback on_stop)
+: device_fd_(device_fd), pty_fd_(pty_fd), capture_(capture), on_stop_(std::move(on_stop))
+{
+  if (pipe(stop_fd_) != 0) {
+    throw std::runtime_error(std::string("Cannot create the link tap pipe: ") + std::strerror(errno));
+  }
+#ifdef ROS2_GREMSY_TRACING_ENABLED
+  // Not on a MAVLink channel, the taps of the drivers in the same process run in parallel
+  rx_parser_ = std::make_unique<MavlinkParser>();
+#endif
+  thread_ = std::thread(&LinkTap::run, this);
+}
+
+LinkTap::~LinkTap()
+{
+  const uint8_t stop = 1;
+  writeAll(stop_fd_[1], &stop, 1);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(stop_fd_[0]);
+  close(stop_fd_[1]);
+  close(device_fd_);
+  close(pty_fd_);
+}
+
+std::string LinkTap::stopReason() const
+{
+  std::lock_guard<std::mutex> lock(stop_mutex_);
+  return stop_reason_;
+}
+
+int LinkTap::openSerialDevice(const std::string & path, int baudrate)
+{
+  const speed_t speed = toSpeed(baudrate);
+  const int fd = open(path.c_str(), O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+  }
+  try {
+    makeRaw(fd, path);
+    termios config{};
+    tcgetattr(fd, &config);
+    cfsetispeed(&config, speed);
+    cfsetospeed(&config, speed);
+    if (tcsetattr(fd, TCSANOW, &config) != 0) {
+      throw std::runtime_error("Cannot set the baudrate of " + path + ": " + std::strerror(errno));
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  return fd;
+}
+
+int LinkTap::openPseudoTerminal(std::string & slave_path)
+{
+  const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("Cannot open a pseudo terminal: ") + std::strerror(errno));
+  }
+  char name[128];
+  if (grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, name, sizeof(name)) != 0) {
+    close(fd);
+    throw std::runtime_error(std::string("Cannot set up the pseudo terminal: ") + std::strerror(errno));
+  }
+  try {
+    makeRaw(fd, name);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  slave_path = name;
+  return fd;
+}
+
+void LinkTap::fail(const std::string & reason)
+{
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    stop_reason_ = reason;
+  }
+  if (on_stop_) {
+    on_stop_(reason);
+  }
+  stopped_.store(true, std::memory_order_release);
+}
+
+void LinkTap::run()
+{
+  pollfd fds[3] = {
+    {device_fd_, POLLIN, 0},
+    {pty_fd_, POLLIN, 0},
+    {stop_fd_[0], POLLIN, 0},
+  };
+  bool pty_hung_up = false;
+  while (true) {
+    // While nobody has the slave side open, e.g. before gSDK opens it or while it reopens
+    // it, the pseudo terminal reports POLLHUP at once. It is left out of the poll for 10 ms
+    // then, so that the device is still served without spinning.
+    fds[1].fd = pty_hung_up ? -1 : pty_fd_;
+    if (poll(fds, 3, pty_hung_up ? 10 : -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fail(std::string("Link tap poll failed: ") + std::strerror(errno));
+      return;
+    }
+    pty_hung_up = false;
+    if (fds[2].revents != 0) {
+      return;
+    }
+    if ((fds[0].revents & POLLIN) != 0) {
+      if (!forward(device_fd_, pty_fd_, LinkDirection::RX, rx_bytes_)) {
+        return;
+      }
+    } else if ((fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+      fail("Serial device hung up");
+      return;
+    }
+    if ((fds[1].revents & POLLIN) != 0) {
+      if (!forward(pty_fd_, device_fd_, LinkDirection::TX, tx_bytes_)) {
+        return;
+      }
+    } else if ((fds[1].revents & POLLHUP) != 0) {
+      pty_hung_up = true;
+    }
+  }
+}
+
+bool LinkTap::forward(int from, int to, LinkDirection direction, std::atomic<uint64_t> & counter)
+{
+  const char * const name = direction == LinkDirection::RX ? "RX" : "TX";
+  uint8_t buffer[kChunkSize];
+  const ssize_t size = ::read(from, buffer, sizeof(buffer));
+  if (size <= 0) {
+    if (size == 0 && from == device_fd_) {
+      fail("Serial device closed");
+      return false;
+    }
+    // A closed slave side reads as an error on the master, which is not fatal
+    if (size == 0 || errno == EINTR || errno == EAGAIN || (from == pty_fd_ && errno == EIO)) {
+      return true;
+    }
+    fail(std::string(name) + " read failed: " + std::strerror(errno));
+    return false;
+  }
+  if (capture_) {
+    capture_->record(direction, buffer, static_cast<std::size_t>(size));
+  }
+  counter.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+
+#ifdef ROS2_GREMSY_TRACING_ENABLED
+  if (direction == LinkDirection::RX) {
+    GREMSY_TRACEPOINT(serial_read, this, static_cast<uint64_t>(size));
+    for (ssize_t i = 0; i < size; ++i) {
+      if (rx_parser_->parse(buffer[i])) {
+        GREMSY_TRACEPOINT(
+          mavlink_frame, this, rx_parser_->message().msgid, rx_parser_->message().seq);
+      }
+    }
+  }
+#endif
+
+  if (!writeAll(to, buffer, static_cast<std::size_t>(size))) {
+    // Bytes for a closed slave side are dropped, gSDK resynchronizes on the next frame
+    if (to == pty_fd_ && errno == EIO) {
+      return true;
+    }
+    fail(std::string(name) + " write failed: " + std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,104 @@
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "ros2_gremsy/periodic_thread.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Sleep until a deadline of the steady clock, which is CLOCK_MONOTONIC on Linux
+void sleepUntil(PeriodicThread::Clock::time_point deadline)
+{
+  const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    deadline.time_since_epoch()).count();
+  timespec ts;
+  ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+  ts.tv_nsec = static_cast<long>(ns % 1000000000);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+  }
+}
+}  // namespace
+
+PeriodicThread::PeriodicThread(const Config & config, Callback callback)
+: config_(config), callback_(std::move(callback))
+{
+}
+
+PeriodicThread::~PeriodicThread()
+{
+  stop();
+}
+
+bool PeriodicThread::start(std::chrono::nanoseconds period)
+{
+  if (running_.exchange(true)) {
+    return true;
+  }
+  setPeriod(period);
+  thread_ = std::thread(&PeriodicThread::run, this);
+
+  bool applied = true;
+  if (!config_.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const int cpu : config_.cpus) {
+      CPU_SET(cpu, &cpus);
+    }
+    applied = pthread_setaffinity_np(thread_.native_handle(), sizeof(cpus), &cpus) == 0;
+  }
+  if (config_.priority > 0) {
+    sched_param param{};
+    param.sched_priority = config_.priority;
+    applied = pthread_setschedparam(thread_.native_handle(), SCHED_FIFO, &param) == 0 && applied;
+  }
+  return applied;
+}
+
+void PeriodicThread::stop()
+{
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PeriodicThread::setPeriod(std::chrono::nanoseconds period)
+{
+  period_ns_.store(period.count(), std::memory_order_relaxed);
+}
+
+PeriodicThread::Stats PeriodicThread::stats() const
+{
+  Stats stats;
+  stats.ticks = ticks_.load(std::memory_order_relaxed);
+  stats.overruns = overruns_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void PeriodicThread::run()
+{
+  Clock::time_point deadline = Clock::now();
+  while (running_.load(std::memory_order_relaxed)) {
+    deadline += std::chrono::nanoseconds(period_ns_.load(std::memory_order_relaxed));
+    const Clock::time_point now = Clock::now();
+    if (deadline < now) {
+      // Start over from now rather than catching up with calls back to back
+      overruns_.fetch_add(1, std::memory_order_relaxed);
+      deadline = now;
+    }
+    sleepUntil(deadline);
+    if (!running_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    callback_(deadline);
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace ros2_gremsy
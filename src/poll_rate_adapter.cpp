@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ros2_gremsy/poll_rate_adapter.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Fewer polls do not tell whether the polls see every sample
+constexpr uint64_t kMinPolls = 10;
+/// Fraction of polls with a new sample from which the stream counts as saturated
+constexpr double kSaturation = 0.95;
+}  // namespace
+
+void PollRateAdapter::configure(const Config & config, double rate, Clock::time_point now)
+{
+  config_ = config;
+  rate_ = std::clamp(rate, config_.min_rate, config_.max_rate);
+  stream_rate_ = 0.0;
+  last_adapt_ = now;
+  polls_ = 0;
+  samples_.fill(0);
+}
+
+void PollRateAdapter::poll(const GimbalState & state)
+{
+  const std::array<uint64_t, kStreams> stamps = {
+    state.raw_imu.time_usec, state.mount_status_time_usec, state.mount_orientation_time_usec};
+  ++polls_;
+  for (int i = 0; i < kStreams; ++i) {
+    if (stamps[i] != 0 && stamps[i] != last_stamps_[i]) {
+      ++samples_[i];
+    }
+    last_stamps_[i] = stamps[i];
+  }
+}
+
+double PollRateAdapter::adapt(Clock::time_point now)
+{
+  const double elapsed = std::chrono::duration<double>(now - last_adapt_).count();
+  if (polls_ < kMinPolls || elapsed <= 0.0) {
+    return rate_;
+  }
+
+  double target = 0.0;
+  stream_rate_ = 0.0;
+  for (int i = 0; i < kStreams; ++i) {
+    if (samples_[i] == 0) {
+      continue;
+    }
+    const double stream_rate = static_cast<double>(samples_[i]) / elapsed;
+    stream_rate_ = std::max(stream_rate_, stream_rate);
+    const bool saturated =
+      static_cast<double>(samples_[i]) >= kSaturation * static_cast<double>(polls_);
+    target = std::max(
+      target, saturated ? rate_ * config_.probe_factor : stream_rate * config_.margin);
+  }
+  last_adapt_ = now;
+  polls_ = 0;
+  samples_.fill(0);
+
+  if (target <= 0.0) {
+    // No data, the link diagnostics report it and the rate is kept
+    return rate_;
+  }
+  target = std::clamp(target, config_.min_rate, config_.max_rate);
+  if (std::fabs(target - rate_) > config_.hysteresis * rate_) {
+    rate_ = target;
+  }
+  return rate_;
+}
+
+}  // namespace ros2_gremsy
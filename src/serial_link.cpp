@@ -0,0 +1,61 @@
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "ros2_gremsy/serial_link.hpp"
+#include "ros2_gremsy/link_tap.hpp"
+#include "ros2_gremsy/mavlink_parser.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Listen for a heartbeat until the timeout
+bool receiveHeartbeat(int fd, std::chrono::milliseconds timeout)
+{
+  // Not on a MAVLink channel, other drivers may be probing or running in the same process
+  MavlinkParser parser;
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  for (auto now = std::chrono::steady_clock::now(); now < deadline;
+    now = std::chrono::steady_clock::now())
+  {
+    pollfd fds = {fd, POLLIN, 0};
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+    if (poll(&fds, 1, static_cast<int>(remaining)) <= 0) {
+      continue;
+    }
+    uint8_t buffer[256];
+    const ssize_t size = ::read(fd, buffer, sizeof(buffer));
+    for (ssize_t i = 0; i < size; ++i) {
+      if (parser.parse(buffer[i]) && parser.message().msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+}  // namespace
+
+int probeBaudrate(
+  const std::string & port, const std::vector<int> & candidates,
+  std::chrono::milliseconds timeout)
+{
+  for (const int baudrate : candidates) {
+    if (!isSupportedBaudrate(baudrate)) {
+      continue;
+    }
+    const int fd = LinkTap::openSerialDevice(port, baudrate);
+    // Bytes received at the previous baudrate are garbage
+    tcflush(fd, TCIFLUSH);
+    const bool found = receiveHeartbeat(fd, timeout);
+    close(fd);
+    if (found) {
+      return baudrate;
+    }
+  }
+  return 0;
+}
+
+}  // namespace ros2_gremsy
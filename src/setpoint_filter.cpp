@@ -0,0 +1,67 @@
+#include <cmath>
+
+#include "ros2_gremsy/setpoint_filter.hpp"
+
+namespace ros2_gremsy
+{
+
+void SetpointFilter::configure(const Config & config)
+{
+  config_ = config;
+}
+
+bool SetpointFilter::accept(const Eigen::Vector3d & setpoint, Clock::time_point now)
+{
+  latest_ = setpoint;
+
+  bool changed = !has_sent_;
+  const double scale = moving_ ? 1.0 - config_.hysteresis : 1.0;
+  for (int axis = 0; axis < 3 && !changed; ++axis) {
+    const double threshold = scale * config_.deadband[axis];
+    changed = threshold <= 0.0 || std::fabs(setpoint[axis] - last_sent_[axis]) > threshold;
+  }
+  moving_ = changed;
+
+  if (!changed) {
+    has_pending_ = setpoint != last_sent_;
+    ++counters_.suppressed;
+    return false;
+  }
+  ++counters_.sent;
+  markSent(now);
+  return true;
+}
+
+bool SetpointFilter::keepalive(Clock::time_point now)
+{
+  if (!has_sent_ || config_.keepalive_period.count() <= 0.0 ||
+    now - last_sent_time_ < config_.keepalive_period)
+  {
+    return false;
+  }
+  ++counters_.keepalive;
+  moving_ = has_pending_;
+  markSent(now);
+  return true;
+}
+
+bool SetpointFilter::flush(Clock::time_point now)
+{
+  if (!has_pending_) {
+    return false;
+  }
+  ++counters_.sent;
+  moving_ = false;
+  markSent(now);
+  return true;
+}
+
+void SetpointFilter::markSent(Clock::time_point now)
+{
+  last_sent_ = latest_;
+  last_sent_time_ = now;
+  has_sent_ = true;
+  has_pending_ = false;
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ros2_gremsy/setpoint_shaper.hpp"
+
+namespace ros2_gremsy
+{
+
+namespace
+{
+/// Below this error an axis is always considered to be on its target
+constexpr double kPositionEpsilon = 1e-3;
+/// Bisection steps of the jerk between the admissible and the rejected one
+constexpr int kJerkIterations = 16;
+
+inline double clamp(double value, double limit)
+{
+  return std::fmin(std::fmax(value, -limit), limit);
+}
+
+/**
+ * @brief Shortest distance needed to come to rest with jerk and acceleration limits
+ * @param v Velocity towards the target
+ * @param a Acceleration towards the target
+ * @return Distance travelled until the axis is at rest
+ */
+double stoppingDistance(double v, double a, double a_max, double j_max)
+{
+  // Ramping the acceleration to zero already stops the axis
+  if (v + a * std::fabs(a) / (2.0 * j_max) <= 0.0) {
+    return 0.0;
+  }
+  // Decelerate with -J to the peak deceleration, hold it, then release with +J
+  double a_peak = std::sqrt(j_max * v + 0.5 * a * a);
+  double t_hold = 0.0;
+  if (a_peak > a_max) {
+    a_peak = a_max;
+    t_hold = (v + a * a / (2.0 * j_max) - a_max * a_max / j_max) / a_max;
+  }
+  const double phases[3][2] = {
+    {-j_max, (a + a_peak) / j_max},
+    {0.0, t_hold},
+    {j_max, a_peak / j_max},
+  };
+  double distance = 0.0;
+  for (const auto & phase : phases) {
+    const double j = phase[0];
+    const double t = phase[1];
+    distance += v * t + a * t * t / 2.0 + j * t * t * t / 6.0;
+    v += a * t + j * t * t / 2.0;
+    a += j * t;
+  }
+  return distance;
+}
+}  // namespace
+
+SetpointShaper::SetpointShaper()
+{
+  limits_.velocity.setZero();
+  limits_.acceleration.setZero();
+  limits_.jerk.setZero();
+  position_.setZero();
+  velocity_.setZero();
+  acceleration_.setZero();
+  target_.setZero();
+}
+
+void SetpointShaper::setLimits(const Limits & limits)
+{
+  limits_ = limits;
+}
+
+bool SetpointShaper::validLimits(const Limits & limits, double dt)
+{
+  for (int axis = 0; axis < 3; ++axis) {
+    const double v_max = limits.velocity[axis];
+    const double a_max = limits.acceleration[axis];
+    const double j_max = limits.jerk[axis];
+    if (v_max <= 0.0 || a_max <= 0.0 || j_max <= 0.0) {
+      continue;
+    }
+    if (j_max * dt > a_max || 0.5 * j_max * dt * dt > v_max) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SetpointShaper::reset(const Eigen::Vector3d & position)
+{
+  position_ = position;
+  target_ = position;
+  velocity_.setZero();
+  acceleration_.setZero();
+  initialized_ = true;
+  settled_ = true;
+}
+
+void SetpointShaper::setTarget(const Eigen::Vector3d & target)
+{
+  target_ = target;
+  settled_ = false;
+}
+
+const Eigen::Vector3d & SetpointShaper::step(double dt)
+{
+  if (settled_ || dt <= 0.0) {
+    return position_;
+  }
+  bool settled = true;
+  for (int axis = 0; axis < 3; ++axis) {
+    settled &= stepAxis(axis, dt);
+  }
+  settled_ = settled;
+  return position_;
+}
+
+bool SetpointShaper::stepAxis(int axis, double dt)
+{
+  const double v_max = limits_.velocity[axis];
+  const double a_max = limits_.acceleration[axis];
+  const double j_max = limits_.jerk[axis];
+  double & p = position_[axis];
+  double & v = velocity_[axis];
+  double & a = acceleration_[axis];
+
+  const double error = target_[axis] - p;
+
+  // Axis without limits follows the target directly
+  if (v_max <= 0.0 || a_max <= 0.0 || j_max <= 0.0) {
+    p = target_[axis];
+    v = 0.0;
+    a = 0.0;
+    return true;
+  }
+
+  // Within what one tick at full acceleration can reach, finish on the target. Closer to
+  // the target, the jerk and acceleration steps can circle around it instead of settling.
+  if (std::fabs(error) <= std::fmax(kPositionEpsilon, a_max * dt * dt) &&
+    std::fabs(v) <= a_max * dt)
+  {
+    p = target_[axis];
+    v = 0.0;
+    a = 0.0;
+    return true;
+  }
+
+  // Work in the direction of the target, so that the error is positive
+  const double direction = error < 0.0 ? -1.0 : 1.0;
+  const double distance = direction * error;
+  const double v_dir = direction * v;
+  const double a_dir = direction * a;
+
+  // Pick the largest jerk after which the axis can still stop on the target
+  // and stay below the velocity limit. Braking at full jerk is the fallback.
+  double v_next = 0.0;
+  double a_next = 0.0;
+  double travel = 0.0;
+  const auto admissible = [&](double jerk) {
+      a_next = clamp(a_dir + jerk * dt, a_max);
+      v_next = std::fmin(v_dir + 0.5 * (a_dir + a_next) * dt, v_max);
+      travel = 0.5 * (v_dir + v_next) * dt;
+      const bool below_velocity_limit =
+        a_next <= 0.0 || v_next + a_next * a_next / (2.0 * j_max) <= v_max;
+      return below_velocity_limit &&
+             stoppingDistance(v_next, a_next, a_max, j_max) <= distance - travel;
+    };
+  const bool full_jerk = admissible(j_max);
+  if (!full_jerk && !admissible(0.0)) {
+    admissible(-j_max);
+  } else if (!full_jerk && travel <= 0.0) {
+    // From rest, full jerk can overshoot a low velocity limit while no jerk does not
+    // move at all, so search the largest admissible jerk in between
+    double low = 0.0;
+    double high = j_max;
+    for (int i = 0; i < kJerkIterations; ++i) {
+      const double jerk = 0.5 * (low + high);
+      if (admissible(jerk)) {
+        low = jerk;
+      } else {
+        high = jerk;
+      }
+    }
+    admissible(low);
+  }
+
+  p += direction * travel;
+  v = direction * v_next;
+  a = direction * a_next;
+  return false;
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <utility>
+
+#include "ros2_gremsy/stream_rate_controller.hpp"
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace ros2_gremsy
+{
+
+StreamRateController::StreamRateController(RequestFunction request)
+: request_(std::move(request))
+{
+}
+
+void StreamRateController::configure(const Config & config)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  config_ = config;
+  failed_.fill(false);
+}
+
+bool StreamRateController::update(const std::array<bool, NUM_STREAMS> & consumed)
+{
+  Rates targets;
+  Rates requested;
+  std::array<bool, NUM_STREAMS> failed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < NUM_STREAMS; ++i) {
+      const double rate = config_.rates[i];
+      targets[i] = rate >= 0.0 && !consumed[i] && config_.idle_rate >= 0.0 ?
+        std::min(config_.idle_rate, rate) : rate;
+    }
+    requested = requested_;
+    failed = failed_;
+  }
+
+  // Requests wait for their acknowledgement, so they are sent without holding the lock
+  bool accepted = true;
+  for (int i = 0; i < NUM_STREAMS; ++i) {
+    if (targets[i] < 0.0 || targets[i] == requested[i] || failed[i]) {
+      failed[i] = false;
+      continue;
+    }
+    // Only this request's outcome is stored, a configure in between keeps its reset
+    failed[i] = !request_(messageId(static_cast<Stream>(i)), targets[i]);
+    if (!failed[i]) {
+      requested[i] = targets[i];
+    }
+    accepted = accepted && !failed[i];
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  requested_ = requested;
+  for (int i = 0; i < NUM_STREAMS; ++i) {
+    failed_[i] = failed_[i] || failed[i];
+  }
+  return accepted;
+}
+
+StreamRateController::Rates StreamRateController::requested() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return requested_;
+}
+
+uint32_t StreamRateController::messageId(Stream stream)
+{
+  switch (stream) {
+    case RAW_IMU: return MAVLINK_MSG_ID_RAW_IMU;
+    case MOUNT_STATUS: return MAVLINK_MSG_ID_MOUNT_STATUS;
+    case MOUNT_ORIENTATION: return MAVLINK_MSG_ID_MOUNT_ORIENTATION;
+    default: return 0;
+  }
+}
+
+const char * StreamRateController::name(Stream stream)
+{
+  switch (stream) {
+    case RAW_IMU: return "raw IMU";
+    case MOUNT_STATUS: return "mount status";
+    case MOUNT_ORIENTATION: return "mount orientation";
+    default: return "unknown";
+  }
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,83 @@
+#include "ros2_gremsy/topic_qos.hpp"
+
+namespace ros2_gremsy
+{
+using rclcpp::QosPolicyKind;
+
+QosEvents::QosEvents(const rclcpp::Logger & logger)
+: logger_(logger)
+{
+}
+
+rclcpp::PublisherOptions QosEvents::publisherOptions(const std::string & topic)
+{
+  rclcpp::PublisherOptions options;
+  options.qos_overriding_options = rclcpp::QosOverridingOptions(
+  {
+    QosPolicyKind::Reliability, QosPolicyKind::History, QosPolicyKind::Depth,
+    QosPolicyKind::Durability, QosPolicyKind::Deadline, QosPolicyKind::Lifespan,
+    QosPolicyKind::Liveliness, QosPolicyKind::LivelinessLeaseDuration});
+  options.event_callbacks.deadline_callback =
+    [this, topic](rclcpp::QOSDeadlineOfferedInfo & event) {
+      count(deadlines_missed_, topic, event.total_count_change);
+    };
+  options.event_callbacks.liveliness_callback =
+    [this, topic](rclcpp::QOSLivelinessLostInfo & event) {
+      count(liveliness_lost_, topic, event.total_count_change);
+    };
+  options.event_callbacks.incompatible_qos_callback =
+    [this, topic](rclcpp::QOSOfferedIncompatibleQoSInfo & event) {
+      count(incompatible_qos_, topic, event.total_count_change);
+      RCLCPP_WARN(logger_, "A subscription of %s requested an incompatible %s policy",
+        topic.c_str(), rclcpp::qos_policy_name_from_kind(event.last_policy_kind).c_str());
+    };
+  return options;
+}
+
+rclcpp::SubscriptionOptions QosEvents::subscriptionOptions(const std::string & topic)
+{
+  // Lifespan is a policy of the publishers only
+  rclcpp::SubscriptionOptions options;
+  options.qos_overriding_options = rclcpp::QosOverridingOptions(
+  {
+    QosPolicyKind::Reliability, QosPolicyKind::History, QosPolicyKind::Depth,
+    QosPolicyKind::Durability, QosPolicyKind::Deadline, QosPolicyKind::Liveliness,
+    QosPolicyKind::LivelinessLeaseDuration});
+  options.event_callbacks.deadline_callback =
+    [this, topic](rclcpp::QOSDeadlineRequestedInfo & event) {
+      count(deadlines_missed_, topic, event.total_count_change);
+    };
+  options.event_callbacks.liveliness_callback =
+    [this, topic](rclcpp::QOSLivelinessChangedInfo & event) {
+      if (event.not_alive_count_change > 0) {
+        count(liveliness_lost_, topic, event.not_alive_count_change);
+      }
+    };
+  options.event_callbacks.incompatible_qos_callback =
+    [this, topic](rclcpp::QOSRequestedIncompatibleQoSInfo & event) {
+      count(incompatible_qos_, topic, event.total_count_change);
+      RCLCPP_WARN(logger_, "A publisher of %s offered an incompatible %s policy",
+        topic.c_str(), rclcpp::qos_policy_name_from_kind(event.last_policy_kind).c_str());
+    };
+  return options;
+}
+
+QosEvents::Counts QosEvents::counts() const
+{
+  Counts counts;
+  counts.deadlines_missed = deadlines_missed_.load(std::memory_order_relaxed);
+  counts.liveliness_lost = liveliness_lost_.load(std::memory_order_relaxed);
+  counts.incompatible_qos = incompatible_qos_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  counts.last_topic = last_topic_;
+  return counts;
+}
+
+void QosEvents::count(std::atomic<uint64_t> & counter, const std::string & topic, uint64_t change)
+{
+  counter.fetch_add(change, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  last_topic_ = topic;
+}
+
+}  // namespace ros2_gremsy
@@ -0,0 +1,6 @@
+// Defines the probes of the ros2_gremsy LTTng tracepoint provider, built only with -DTRACING=ON
+
+#define TRACEPOINT_CREATE_PROBES
+#define TRACEPOINT_DEFINE
+
+#include "ros2_gremsy/tp_gremsy.h"
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "ros2_gremsy/command_scheduler.hpp"
+#include "ros2_gremsy/device_traits.hpp"
+#include "ros2_gremsy/gimbal_state_publisher.hpp"
+#include "ros2_gremsy/setpoint_filter.hpp"
+#include "ros2_gremsy/setpoint_shaper.hpp"
+
+#include "allocation_counter.hpp"
+#include "fake_gimbal.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+constexpr double kPollPeriod = 1.0 / 300.0;
+/// Cycles run before counting allocations, so that one-time initialization is excluded
+constexpr int kWarmupCycles = 1000;
+constexpr int kCycles = 10000;
+
+geometry_msgs::msg::Vector3 goalAt(int i)
+{
+  geometry_msgs::msg::Vector3 goal;
+  goal.x = 0.1 * std::sin(0.01 * i);
+  goal.y = -0.5 + 0.3 * std::cos(0.01 * i);
+  goal.z = 3.0 * std::sin(0.003 * i);
+  return goal;
+}
+
+/// The per-tick paths that are fully under the control of the driver must not allocate
+class AllocationTest : public ::testing::TestWithParam<bool>
+{
+protected:
+  static void SetUpTestSuite() {rclcpp::init(0, nullptr);}
+  static void TearDownTestSuite() {rclcpp::shutdown();}
+};
+}  // namespace
+
+TEST_P(AllocationTest, StateUpdate)
+{
+  auto node = std::make_shared<rclcpp::Node>("gremsy_allocation_test");
+  GimbalStatePublisher::Config config;
+  config.imu.accel_scale = NOMINAL_ACCEL_SCALE;
+  config.imu.gyro_scale = NOMINAL_GYRO_SCALE;
+  config.attitude_filter = GetParam();
+  config.use_ros_time = true;
+  GimbalStatePublisher publisher(*node, config);
+  FakeGimbal gimbal;
+  for (int i = 0; i < kWarmupCycles; ++i) {
+    publisher.update(gimbal.poll(kPollPeriod));
+  }
+  AllocationScope allocations;
+  for (int i = 0; i < kCycles; ++i) {
+    publisher.update(gimbal.poll(kPollPeriod));
+  }
+  EXPECT_EQ(allocations.allocations(), 0u);
+}
+
+TEST_P(AllocationTest, GoalPath)
+{
+  const bool shaping = GetParam();
+  const PrepareGimbalMoveFunction prepare = getPrepareGimbalMove(GREMSY_T3V3);
+  CommandScheduler scheduler(
+    CommandScheduler::Config(), [](const Eigen::Vector3d &) {},
+    []() {return CommandScheduler::Ack();});
+  scheduler.start();
+
+  SetpointFilter filter;
+  SetpointFilter::Config filter_config;
+  filter_config.deadband = Eigen::Vector3d::Constant(0.05);
+  filter.configure(filter_config);
+
+  SetpointShaper shaper;
+  SetpointShaper::Limits limits;
+  limits.velocity = Eigen::Vector3d::Constant(90.0);
+  limits.acceleration = Eigen::Vector3d::Constant(180.0);
+  limits.jerk = Eigen::Vector3d::Constant(720.0);
+  shaper.setLimits(limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+
+  AllocationScope allocations;
+  for (int i = 0; i < kCycles; ++i) {
+    Eigen::Vector3d setpoint = prepare(goalAt(i), false, 0.2, 170.0);
+    if (shaping) {
+      shaper.setTarget(setpoint);
+      setpoint = shaper.step(kPollPeriod);
+    }
+    if (filter.accept(setpoint, SetpointFilter::Clock::now())) {
+      scheduler.submitSetpoint(setpoint);
+    }
+  }
+  const uint64_t allocated = allocations.allocations();
+  scheduler.stop();
+  EXPECT_EQ(allocated, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P(AttitudeFilterOrShaping, AllocationTest, ::testing::Bool());
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "ros2_gremsy/attitude_filter.hpp"
+
+namespace
+{
+using ros2_gremsy::AttitudeFilter;
+
+constexpr double kTolerance = 1e-6;
+
+AttitudeFilter makeFilter(double time_constant)
+{
+  AttitudeFilter::Config config;
+  config.time_constant = time_constant;
+  config.gyro_signs = Eigen::Vector3d::Ones();
+  AttitudeFilter filter;
+  filter.configure(config);
+  return filter;
+}
+}  // namespace
+
+TEST(AttitudeFilter, IntegratesGyroInMicroseconds)
+{
+  AttitudeFilter filter = makeFilter(0.5);
+  filter.correct(Eigen::Quaterniond::Identity(), 1000000);
+  ASSERT_TRUE(filter.initialized());
+
+  // 0.5 rad/s about z for one second, in 5 ms samples
+  const Eigen::Vector3d gyro(0.0, 0.0, 0.5);
+  for (uint64_t time_usec = 1000000; time_usec <= 2000000; time_usec += 5000) {
+    filter.predict(gyro, time_usec);
+  }
+  const Eigen::AngleAxisd rotation(filter.orientation());
+  EXPECT_NEAR(rotation.angle(), 0.5, kTolerance);
+  EXPECT_NEAR(rotation.axis().z(), 1.0, kTolerance);
+}
+
+TEST(AttitudeFilter, RepeatedGyroSampleIsIgnored)
+{
+  AttitudeFilter filter = makeFilter(0.5);
+  filter.correct(Eigen::Quaterniond::Identity(), 1000000);
+  EXPECT_TRUE(filter.predict(Eigen::Vector3d(0.0, 0.0, 1.0), 1000000));
+  EXPECT_TRUE(filter.predict(Eigen::Vector3d(0.0, 0.0, 1.0), 1010000));
+  EXPECT_FALSE(filter.predict(Eigen::Vector3d(0.0, 0.0, 1.0), 1010000));
+  EXPECT_NEAR(Eigen::AngleAxisd(filter.orientation()).angle(), 0.01, kTolerance);
+}
+
+TEST(AttitudeFilter, CorrectionFollowsTimeConstant)
+{
+  AttitudeFilter filter = makeFilter(1.0);
+  filter.correct(Eigen::Quaterniond::Identity(), 1000000);
+
+  // One time constant later, the gain is dt / (tau + dt) = 0.5
+  const Eigen::Quaterniond target(Eigen::AngleAxisd(0.2, Eigen::Vector3d::UnitX()));
+  filter.correct(target, 2000000);
+  EXPECT_NEAR(Eigen::AngleAxisd(filter.orientation()).angle(), 0.1, kTolerance);
+
+  // The same report again does not pull any further
+  filter.correct(target, 2000000);
+  EXPECT_NEAR(Eigen::AngleAxisd(filter.orientation()).angle(), 0.1, kTolerance);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "ros2_gremsy/command_scheduler.hpp"
+
+namespace
+{
+using ros2_gremsy::CommandScheduler;
+
+/// Gimbal answering each command with the COMMAND_ACKs queued for it
+class FakeGimbal
+{
+public:
+  /// Queue the ACK sent in reply to the next command
+  void replyWith(std::vector<CommandScheduler::Ack> acks)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    replies_.push_back(std::move(acks));
+  }
+
+  /// Write a command, its replies are received at once
+  void send()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++sent_;
+    if (replies_.empty()) {
+      return;
+    }
+    for (CommandScheduler::Ack ack : replies_.front()) {
+      ack.stamp = ++stamp_;
+      latest_ = ack;
+    }
+    replies_.erase(replies_.begin());
+  }
+
+  CommandScheduler::Ack latest() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+  }
+
+  int sent() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<std::vector<CommandScheduler::Ack>> replies_;
+  CommandScheduler::Ack latest_;
+  uint64_t stamp_ = 0;
+  int sent_ = 0;
+};
+
+CommandScheduler::Ack ack(uint16_t command, uint8_t result)
+{
+  CommandScheduler::Ack ack;
+  ack.command = command;
+  ack.result = result;
+  return ack;
+}
+
+class CommandSchedulerTest : public ::testing::Test
+{
+protected:
+  CommandSchedulerTest()
+  : scheduler_(config(), [](const Eigen::Vector3d &) {}, [this]() {return gimbal_.latest();})
+  {
+    scheduler_.start();
+  }
+
+  static CommandScheduler::Config config()
+  {
+    CommandScheduler::Config config;
+    config.ack_timeout = std::chrono::milliseconds(20);
+    config.max_retries = 2;
+    return config;
+  }
+
+  bool submit(uint16_t command)
+  {
+    return scheduler_.submitCommand("test", command, [this]() {gimbal_.send();}).get();
+  }
+
+  FakeGimbal gimbal_;
+  CommandScheduler scheduler_;
+};
+}  // namespace
+
+TEST_F(CommandSchedulerTest, AcceptedAck)
+{
+  gimbal_.replyWith({ack(MAV_CMD_USER_2, MAV_RESULT_ACCEPTED)});
+  EXPECT_TRUE(submit(MAV_CMD_USER_2));
+  EXPECT_EQ(gimbal_.sent(), 1);
+  EXPECT_EQ(scheduler_.stats().acked, 1u);
+}
+
+TEST_F(CommandSchedulerTest, DeniedAckFailsWithoutRetry)
+{
+  gimbal_.replyWith({ack(MAV_CMD_SET_MESSAGE_INTERVAL, MAV_RESULT_UNSUPPORTED)});
+  EXPECT_FALSE(submit(MAV_CMD_SET_MESSAGE_INTERVAL));
+  EXPECT_EQ(gimbal_.sent(), 1);
+  const CommandScheduler::Stats stats = scheduler_.stats();
+  EXPECT_EQ(stats.failed, 1u);
+  EXPECT_EQ(stats.rejected, 1u);
+  EXPECT_EQ(scheduler_.lastFailedCommand(), "test rejected with MAV_RESULT 3");
+}
+
+TEST_F(CommandSchedulerTest, TemporarilyRejectedIsRetried)
+{
+  gimbal_.replyWith({ack(MAV_CMD_USER_2, MAV_RESULT_TEMPORARILY_REJECTED)});
+  gimbal_.replyWith({ack(MAV_CMD_USER_2, MAV_RESULT_ACCEPTED)});
+  EXPECT_TRUE(submit(MAV_CMD_USER_2));
+  EXPECT_EQ(gimbal_.sent(), 2);
+  EXPECT_EQ(scheduler_.stats().retries, 1u);
+}
+
+TEST_F(CommandSchedulerTest, AckOfAnotherCommandIsIgnored)
+{
+  // A late ACK of a setpoint does not acknowledge the mode change
+  gimbal_.replyWith({ack(MAV_CMD_DO_MOUNT_CONTROL, MAV_RESULT_ACCEPTED)});
+  gimbal_.replyWith({ack(MAV_CMD_DO_MOUNT_CONTROL, MAV_RESULT_ACCEPTED),
+      ack(MAV_CMD_USER_2, MAV_RESULT_ACCEPTED)});
+  EXPECT_TRUE(submit(MAV_CMD_USER_2));
+  EXPECT_EQ(gimbal_.sent(), 2);
+}
+
+TEST_F(CommandSchedulerTest, MissingAckFailsAfterRetries)
+{
+  EXPECT_FALSE(submit(MAV_CMD_DO_MOUNT_CONFIGURE));
+  EXPECT_EQ(gimbal_.sent(), 3);
+  const CommandScheduler::Stats stats = scheduler_.stats();
+  EXPECT_EQ(stats.failed, 1u);
+  EXPECT_EQ(stats.rejected, 0u);
+  EXPECT_EQ(scheduler_.lastFailedCommand(), "test not acknowledged");
+}
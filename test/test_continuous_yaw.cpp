@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "ros2_gremsy/continuous_yaw.hpp"
+
+namespace
+{
+using ros2_gremsy::ContinuousYaw;
+using ros2_gremsy::shortestReachableYaw;
+using ros2_gremsy::unwrapNear;
+
+constexpr double kTolerance = 1e-9;
+}  // namespace
+
+TEST(ContinuousYaw, UnwrapNearPicksClosestTurn)
+{
+  EXPECT_NEAR(unwrapNear(10.0, 0.0), 10.0, kTolerance);
+  EXPECT_NEAR(unwrapNear(-170.0, 170.0), 190.0, kTolerance);
+  EXPECT_NEAR(unwrapNear(170.0, -170.0), -190.0, kTolerance);
+  EXPECT_NEAR(unwrapNear(0.0, 700.0), 720.0, kTolerance);
+  EXPECT_NEAR(unwrapNear(45.0, -300.0), -315.0, kTolerance);
+}
+
+TEST(ContinuousYaw, ShortestWayAcrossHalfTurn)
+{
+  // From 170 degrees, -170 is 20 degrees further on, and 190 is reachable
+  EXPECT_NEAR(shortestReachableYaw(-170.0, 170.0, -345.0, 345.0), 190.0, kTolerance);
+  EXPECT_NEAR(shortestReachableYaw(170.0, -170.0, -345.0, 345.0), -190.0, kTolerance);
+}
+
+TEST(ContinuousYaw, OtherWayAroundWhenShortestIsOutOfRange)
+{
+  // 350 is past the stop, the goal is reached at -10 by turning back
+  EXPECT_NEAR(shortestReachableYaw(-10.0, 320.0, -345.0, 345.0), -10.0, kTolerance);
+  EXPECT_NEAR(shortestReachableYaw(10.0, -320.0, -345.0, 345.0), 10.0, kTolerance);
+}
+
+TEST(ContinuousYaw, ClampedWhenNoTurnIsReachable)
+{
+  // Neither 180 nor -180 is inside a +-90 degrees range
+  EXPECT_NEAR(shortestReachableYaw(180.0, 80.0, -90.0, 90.0), 90.0, kTolerance);
+  EXPECT_NEAR(shortestReachableYaw(180.0, -80.0, -90.0, 90.0), -90.0, kTolerance);
+}
+
+TEST(ContinuousYaw, TracksTurnsAcrossWrap)
+{
+  ContinuousYaw tracker;
+  EXPECT_FALSE(tracker.initialized());
+  // The first reading is taken as the pan angle
+  tracker.update(150.0);
+  EXPECT_TRUE(tracker.initialized());
+  EXPECT_NEAR(tracker.angle(), 150.0, kTolerance);
+
+  // One and a half turns in steps below half a turn
+  double reading = 150.0;
+  for (int step = 0; step < 18; ++step) {
+    reading = ros2_gremsy::wrapAngle(reading + 30.0);
+    tracker.update(reading);
+  }
+  EXPECT_NEAR(tracker.angle(), 150.0 + 540.0, kTolerance);
+
+  // And back past the starting turn
+  for (int step = 0; step < 30; ++step) {
+    reading = ros2_gremsy::wrapAngle(reading - 30.0);
+    tracker.update(reading);
+  }
+  EXPECT_NEAR(tracker.angle(), 150.0 - 360.0, kTolerance);
+}
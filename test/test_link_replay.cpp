@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ros2_gremsy/link_capture.hpp"
+#include "ros2_gremsy/link_replay.hpp"
+#include <../../gSDK/src/gimbal_interface.h>
+
+namespace
+{
+using ros2_gremsy::CaptureReader;
+using ros2_gremsy::CaptureRecordHeader;
+using ros2_gremsy::LinkCapture;
+using ros2_gremsy::LinkDirection;
+using ros2_gremsy::LinkReplay;
+
+/// Bytes of a MAVLink heartbeat frame from the gimbal
+std::vector<uint8_t> heartbeatFrame(uint8_t sequence)
+{
+  mavlink_heartbeat_t heartbeat{};
+  heartbeat.type = MAV_TYPE_GIMBAL;
+  heartbeat.autopilot = MAV_AUTOPILOT_INVALID;
+  heartbeat.custom_mode = sequence;
+  mavlink_message_t message;
+  mavlink_msg_heartbeat_encode(1, MAV_COMP_ID_GIMBAL, &message, &heartbeat);
+  std::vector<uint8_t> frame(MAVLINK_MAX_PACKET_LEN);
+  frame.resize(mavlink_msg_to_send_buffer(frame.data(), &message));
+  return frame;
+}
+
+/// Captures written to a temporary directory, removed afterwards
+class LinkReplayTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    char directory[] = "/tmp/ros2_gremsy_test_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    directory_ = directory;
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(directory_);
+  }
+
+  /// Record the chunks with LinkCapture, return the capture file
+  std::string capture(const std::vector<std::pair<LinkDirection, std::vector<uint8_t>>> & chunks)
+  {
+    LinkCapture::Config config;
+    config.directory = directory_;
+    {
+      LinkCapture link_capture(config);
+      for (const auto & chunk : chunks) {
+        link_capture.record(chunk.first, chunk.second.data(), chunk.second.size());
+      }
+    }
+    std::vector<std::string> files;
+    for (const auto & entry : std::filesystem::directory_iterator(directory_)) {
+      files.push_back(entry.path().string());
+    }
+    EXPECT_EQ(files.size(), 1u);
+    return files.empty() ? std::string() : files.front();
+  }
+
+  std::string directory_;
+};
+}  // namespace
+
+TEST_F(LinkReplayTest, ReadsRecordsBack)
+{
+  const std::vector<uint8_t> rx = heartbeatFrame(0);
+  const std::vector<uint8_t> tx = {1, 2, 3};
+  CaptureReader reader(capture({{LinkDirection::RX, rx}, {LinkDirection::TX, tx}}));
+
+  CaptureRecordHeader header;
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(reader.next(header, data));
+  EXPECT_EQ(header.direction, LinkDirection::RX);
+  EXPECT_EQ(data, rx);
+  ASSERT_TRUE(reader.next(header, data));
+  EXPECT_EQ(header.direction, LinkDirection::TX);
+  EXPECT_EQ(data, tx);
+  EXPECT_FALSE(reader.next(header, data));
+}
+
+TEST_F(LinkReplayTest, RejectsOtherFiles)
+{
+  const std::string path = directory_ + "/other.cap";
+  std::ofstream(path) << "not a capture";
+  EXPECT_THROW(CaptureReader reader(path), std::runtime_error);
+}
+
+TEST_F(LinkReplayTest, PlaysReceivedSide)
+{
+  // The second frame is cut across two records, with a command in between
+  const std::vector<uint8_t> first = heartbeatFrame(1);
+  const std::vector<uint8_t> second = heartbeatFrame(2);
+  std::vector<uint8_t> chunk = first;
+  chunk.insert(chunk.end(), second.begin(), second.begin() + 4);
+  const std::vector<uint8_t> rest(second.begin() + 4, second.end());
+  const std::string path = capture({
+      {LinkDirection::RX, chunk}, {LinkDirection::TX, {1, 2, 3}}, {LinkDirection::RX, rest}});
+
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  LinkReplay::Config config;
+  config.files = {path};
+  config.rate = 0.0;
+  LinkReplay replay(fds[0], config);
+
+  std::vector<uint8_t> expected = first;
+  expected.insert(expected.end(), second.begin(), second.end());
+  std::vector<uint8_t> played(expected.size());
+  std::size_t received = 0;
+  while (received < played.size()) {
+    const ssize_t n = read(fds[1], &played[received], played.size() - received);
+    ASSERT_GT(n, 0);
+    received += static_cast<std::size_t>(n);
+  }
+  EXPECT_EQ(played, expected);
+
+  for (int i = 0; i < 100 && !replay.finished(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(replay.finished());
+  const LinkReplay::Stats stats = replay.stats();
+  EXPECT_EQ(stats.records, 2u);
+  EXPECT_EQ(stats.bytes, expected.size());
+  EXPECT_EQ(stats.frames, 2u);
+  close(fds[1]);
+}
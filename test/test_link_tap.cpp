@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "ros2_gremsy/link_tap.hpp"
+
+namespace
+{
+using ros2_gremsy::LinkTap;
+
+/// Socket pairs standing in for the serial device and the pseudo terminal
+class LinkTapTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, device_), 0);
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sdk_), 0);
+  }
+
+  void TearDown() override
+  {
+    for (int fd : {device_[1], sdk_[1]}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  /// Read exactly size bytes, or fewer if the peer closes
+  static std::string readExactly(int fd, std::size_t size)
+  {
+    std::string data(size, '\0');
+    std::size_t received = 0;
+    while (received < size) {
+      const ssize_t n = read(fd, &data[received], size - received);
+      if (n <= 0) {
+        break;
+      }
+      received += static_cast<std::size_t>(n);
+    }
+    data.resize(received);
+    return data;
+  }
+
+  /// The tap owns device_[0] and sdk_[0], the test talks through the other ends
+  int device_[2] = {-1, -1};
+  int sdk_[2] = {-1, -1};
+};
+}  // namespace
+
+TEST_F(LinkTapTest, ForwardsBothDirections)
+{
+  LinkTap tap(device_[0], sdk_[0], nullptr);
+  ASSERT_EQ(write(device_[1], "gimbal", 6), 6);
+  EXPECT_EQ(readExactly(sdk_[1], 6), "gimbal");
+  ASSERT_EQ(write(sdk_[1], "command", 7), 7);
+  EXPECT_EQ(readExactly(device_[1], 7), "command");
+  EXPECT_EQ(tap.rxBytes(), 6u);
+  EXPECT_EQ(tap.txBytes(), 7u);
+  EXPECT_FALSE(tap.stopped());
+  EXPECT_EQ(tap.stopReason(), "");
+}
+
+TEST_F(LinkTapTest, ClosedDeviceStopsWithReason)
+{
+  std::string reported;
+  LinkTap tap(
+    device_[0], sdk_[0], nullptr, [&reported](const std::string & reason) {reported = reason;});
+  close(device_[1]);
+  device_[1] = -1;
+  for (int i = 0; i < 100 && !tap.stopped(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(tap.stopped());
+  EXPECT_EQ(tap.stopReason(), "Serial device closed");
+  EXPECT_EQ(reported, "Serial device closed");
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include "ros2_gremsy/setpoint_filter.hpp"
+
+namespace
+{
+using ros2_gremsy::SetpointFilter;
+using namespace std::chrono_literals;
+
+class SetpointFilterTest : public ::testing::Test
+{
+protected:
+  SetpointFilterTest()
+  {
+    config_.deadband = Eigen::Vector3d::Constant(1.0);
+    filter_.configure(config_);
+  }
+
+  bool accept(double tilt)
+  {
+    return filter_.accept(Eigen::Vector3d(0.0, tilt, 0.0), now_);
+  }
+
+  SetpointFilter::Config config_;
+  SetpointFilter filter_;
+  SetpointFilter::Clock::time_point now_;
+};
+}  // namespace
+
+TEST_F(SetpointFilterTest, FirstSetpointIsSent)
+{
+  EXPECT_TRUE(accept(0.0));
+  EXPECT_EQ(filter_.counters().sent, 1u);
+}
+
+TEST_F(SetpointFilterTest, Deadband)
+{
+  ASSERT_TRUE(accept(0.0));
+  EXPECT_FALSE(accept(0.5));
+  EXPECT_FALSE(accept(-1.0));
+  EXPECT_TRUE(accept(1.5));
+  EXPECT_EQ(filter_.counters().sent, 2u);
+  EXPECT_EQ(filter_.counters().suppressed, 2u);
+}
+
+TEST_F(SetpointFilterTest, ZeroDeadbandSendsEverySetpoint)
+{
+  config_.deadband.y() = 0.0;
+  filter_.configure(config_);
+  ASSERT_TRUE(accept(0.0));
+  EXPECT_TRUE(accept(0.0));
+  EXPECT_TRUE(accept(0.1));
+}
+
+TEST_F(SetpointFilterTest, HysteresisWhileMoving)
+{
+  config_.hysteresis = 0.5;
+  filter_.configure(config_);
+  ASSERT_TRUE(accept(0.0));
+  EXPECT_FALSE(accept(0.3));
+  // At rest the full deadband applies, while moving only half of it
+  EXPECT_FALSE(accept(0.7));
+  EXPECT_TRUE(accept(1.5));
+  EXPECT_TRUE(accept(2.2));
+  EXPECT_FALSE(accept(2.6));
+  // Stopped again, the full deadband is back
+  EXPECT_FALSE(accept(2.9));
+}
+
+TEST_F(SetpointFilterTest, FlushSendsSuppressedSetpoint)
+{
+  EXPECT_FALSE(filter_.flush(now_));
+  ASSERT_TRUE(accept(0.0));
+  EXPECT_FALSE(filter_.flush(now_));
+  ASSERT_FALSE(accept(0.5));
+  EXPECT_TRUE(filter_.flush(now_));
+  EXPECT_EQ(filter_.latest(), Eigen::Vector3d(0.0, 0.5, 0.0));
+  EXPECT_FALSE(filter_.flush(now_));
+  // The flushed setpoint is the new reference of the deadband
+  EXPECT_FALSE(accept(1.4));
+  EXPECT_TRUE(accept(1.6));
+}
+
+TEST_F(SetpointFilterTest, Keepalive)
+{
+  EXPECT_FALSE(filter_.keepalive(now_));
+  ASSERT_TRUE(accept(0.0));
+  // Disabled by default
+  now_ += 10s;
+  EXPECT_FALSE(filter_.keepalive(now_));
+
+  config_.keepalive_period = 1s;
+  filter_.configure(config_);
+  ASSERT_TRUE(accept(2.0));
+  now_ += 500ms;
+  EXPECT_FALSE(filter_.keepalive(now_));
+  ASSERT_FALSE(accept(2.5));
+  now_ += 500ms;
+  EXPECT_TRUE(filter_.keepalive(now_));
+  EXPECT_EQ(filter_.latest(), Eigen::Vector3d(0.0, 2.5, 0.0));
+  EXPECT_FALSE(filter_.keepalive(now_));
+  EXPECT_EQ(filter_.counters().keepalive, 1u);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "ros2_gremsy/setpoint_shaper.hpp"
+
+namespace
+{
+using ros2_gremsy::SetpointShaper;
+
+constexpr double kDt = 0.01;
+/// Slack for the discretization of the limits over one tick
+constexpr double kTolerance = 1e-6;
+
+SetpointShaper::Limits limits(double velocity, double acceleration, double jerk)
+{
+  SetpointShaper::Limits limits;
+  limits.velocity = Eigen::Vector3d::Constant(velocity);
+  limits.acceleration = Eigen::Vector3d::Constant(acceleration);
+  limits.jerk = Eigen::Vector3d::Constant(jerk);
+  return limits;
+}
+
+/**
+ * @brief Step the shaper until it settles, checking the limits of the profile on every tick
+ * The last tick snaps onto the target from below one tick of acceleration, it is not checked.
+ * @return Number of ticks, or -1 if it did not settle within max_ticks
+ */
+int runToTarget(SetpointShaper & shaper, const SetpointShaper::Limits & limits, int max_ticks)
+{
+  Eigen::Vector3d previous_acceleration = shaper.acceleration();
+  for (int tick = 1; tick <= max_ticks; ++tick) {
+    shaper.step(kDt);
+    if (shaper.settled()) {
+      return tick;
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+      if (shaper.velocity()[axis] == 0.0 && shaper.acceleration()[axis] == 0.0) {
+        continue;
+      }
+      EXPECT_LE(std::fabs(shaper.velocity()[axis]), limits.velocity[axis] + kTolerance);
+      EXPECT_LE(std::fabs(shaper.acceleration()[axis]), limits.acceleration[axis] + kTolerance);
+      EXPECT_LE(
+        std::fabs(shaper.acceleration()[axis] - previous_acceleration[axis]),
+        limits.jerk[axis] * kDt + kTolerance);
+    }
+    previous_acceleration = shaper.acceleration();
+  }
+  return -1;
+}
+}  // namespace
+
+TEST(SetpointShaper, ResetStartsAtRest)
+{
+  SetpointShaper shaper;
+  EXPECT_FALSE(shaper.initialized());
+  shaper.reset(Eigen::Vector3d(1.0, 2.0, 3.0));
+  EXPECT_TRUE(shaper.initialized());
+  EXPECT_TRUE(shaper.settled());
+  EXPECT_EQ(shaper.step(kDt), Eigen::Vector3d(1.0, 2.0, 3.0));
+  EXPECT_EQ(shaper.velocity(), Eigen::Vector3d::Zero());
+}
+
+TEST(SetpointShaper, ReachesTargetWithinLimits)
+{
+  const SetpointShaper::Limits shaper_limits = limits(90.0, 180.0, 720.0);
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  const Eigen::Vector3d target(10.0, -45.0, 180.0);
+  shaper.setTarget(target);
+
+  EXPECT_GT(runToTarget(shaper, shaper_limits, 1000), 0);
+  EXPECT_EQ(shaper.position(), target);
+  EXPECT_EQ(shaper.velocity(), Eigen::Vector3d::Zero());
+}
+
+TEST(SetpointShaper, DoesNotOvershoot)
+{
+  const SetpointShaper::Limits shaper_limits = limits(90.0, 180.0, 720.0);
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  shaper.setTarget(Eigen::Vector3d(5.0, 30.0, -120.0));
+  for (int tick = 0; tick < 1000 && !shaper.settled(); ++tick) {
+    const Eigen::Vector3d & position = shaper.step(kDt);
+    EXPECT_LE(position.x(), 5.0 + kTolerance);
+    EXPECT_LE(position.y(), 30.0 + kTolerance);
+    EXPECT_GE(position.z(), -120.0 - kTolerance);
+  }
+  EXPECT_TRUE(shaper.settled());
+}
+
+TEST(SetpointShaper, ReversesWithinLimits)
+{
+  const SetpointShaper::Limits shaper_limits = limits(90.0, 180.0, 720.0);
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  shaper.setTarget(Eigen::Vector3d::Constant(90.0));
+  for (int tick = 0; tick < 50; ++tick) {
+    shaper.step(kDt);
+  }
+  ASSERT_GT(shaper.velocity().minCoeff(), 0.0);
+
+  // A target behind the moving setpoint brakes and comes back without a jump
+  const Eigen::Vector3d target = Eigen::Vector3d::Constant(-20.0);
+  shaper.setTarget(target);
+  EXPECT_GT(runToTarget(shaper, shaper_limits, 2000), 0);
+  EXPECT_EQ(shaper.position(), target);
+}
+
+TEST(SetpointShaper, UnlimitedAxisFollowsTarget)
+{
+  SetpointShaper::Limits shaper_limits = limits(90.0, 180.0, 720.0);
+  shaper_limits.velocity.z() = 0.0;
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  shaper.setTarget(Eigen::Vector3d(10.0, 10.0, 10.0));
+
+  const Eigen::Vector3d & position = shaper.step(kDt);
+  EXPECT_EQ(position.z(), 10.0);
+  EXPECT_LT(position.x(), 10.0);
+  EXPECT_LT(position.y(), 10.0);
+}
+
+TEST(SetpointShaper, LowVelocityLimitLeavesRest)
+{
+  // A full jerk tick from rest overshoots the velocity limit, a partial one does not
+  const SetpointShaper::Limits shaper_limits = limits(5.0, 110.0, 2750.0);
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  const Eigen::Vector3d target(10.0, -20.0, 30.0);
+  shaper.setTarget(target);
+  int tick = 0;
+  for (; tick < 1000 && !shaper.settled(); ++tick) {
+    shaper.step(0.1);
+    EXPECT_LE(shaper.velocity().cwiseAbs().maxCoeff(), 5.0 + kTolerance);
+  }
+  EXPECT_TRUE(shaper.settled());
+  EXPECT_EQ(shaper.position(), target);
+}
+
+TEST(SetpointShaper, AccelerationBelowOneJerkTickSettles)
+{
+  // One tick of jerk is far above the acceleration limit, the axis must not circle the target
+  const SetpointShaper::Limits shaper_limits = limits(90.0, 10.0, 3350.0);
+  SetpointShaper shaper;
+  shaper.setLimits(shaper_limits);
+  shaper.reset(Eigen::Vector3d::Zero());
+  const Eigen::Vector3d target(1.0, -5.0, 20.0);
+  shaper.setTarget(target);
+  for (int tick = 0; tick < 3000 && !shaper.settled(); ++tick) {
+    shaper.step(1.0 / 30.0);
+  }
+  EXPECT_TRUE(shaper.settled());
+  EXPECT_EQ(shaper.position(), target);
+}
+
+TEST(SetpointShaper, ValidLimits)
+{
+  EXPECT_TRUE(SetpointShaper::validLimits(limits(90.0, 180.0, 720.0), 0.1));
+  EXPECT_FALSE(SetpointShaper::validLimits(limits(5.0, 110.0, 2750.0), 0.1));
+  EXPECT_FALSE(SetpointShaper::validLimits(limits(90.0, 10.0, 3350.0), 1.0 / 30.0));
+  EXPECT_FALSE(SetpointShaper::validLimits(limits(0.1, 1000.0, 1000.0), 0.1));
+  // Axes without shaping are not checked
+  SetpointShaper::Limits unshaped = limits(5.0, 110.0, 2750.0);
+  unshaped.velocity.setZero();
+  EXPECT_TRUE(SetpointShaper::validLimits(unshaped, 0.1));
+}
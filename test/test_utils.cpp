@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "ros2_gremsy/utils.hpp"
+
+#include "reference_utils.hpp"
+
+namespace
+{
+using namespace ros2_gremsy;
+
+constexpr double kTolerance = 1e-12;
+constexpr std::size_t kSamples = 1024;
+
+/// Random angles in degrees, in the range of the gimbal orientations
+struct Angles
+{
+  std::vector<double> roll, pitch, yaw;
+
+  explicit Angles(std::size_t n)
+  : roll(n), pitch(n), yaw(n)
+  {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-180.0, 180.0);
+    for (std::size_t i = 0; i < n; ++i) {
+      roll[i] = distribution(generator);
+      pitch[i] = distribution(generator) / 2.0;
+      yaw[i] = distribution(generator);
+    }
+  }
+};
+}  // namespace
+
+TEST(Utils, XYZtoQuaternionMatchesReference)
+{
+  const Angles a(kSamples);
+  geometry_msgs::msg::Quaternion msg;
+  for (std::size_t i = 0; i < kSamples; ++i) {
+    const Eigen::Quaterniond expected = referenceXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i]);
+    const Eigen::Quaterniond actual = convertXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i]);
+    EXPECT_LE((expected.coeffs() - actual.coeffs()).cwiseAbs().maxCoeff(), kTolerance) << i;
+
+    convertXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i], msg);
+    EXPECT_NEAR(msg.w, expected.w(), kTolerance);
+    EXPECT_NEAR(msg.x, expected.x(), kTolerance);
+    EXPECT_NEAR(msg.y, expected.y(), kTolerance);
+    EXPECT_NEAR(msg.z, expected.z(), kTolerance);
+  }
+}
+
+TEST(Utils, XYZtoQuaternionBatchMatchesReference)
+{
+  const Angles a(kSamples);
+  std::vector<double> w(kSamples), x(kSamples), y(kSamples), z(kSamples);
+  convertXYZtoQuaternion(
+    a.roll.data(), a.pitch.data(), a.yaw.data(), kSamples, w.data(), x.data(), y.data(), z.data());
+  for (std::size_t i = 0; i < kSamples; ++i) {
+    const Eigen::Quaterniond expected = referenceXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i]);
+    EXPECT_NEAR(w[i], expected.w(), kTolerance);
+    EXPECT_NEAR(x[i], expected.x(), kTolerance);
+    EXPECT_NEAR(y[i], expected.y(), kTolerance);
+    EXPECT_NEAR(z[i], expected.z(), kTolerance);
+  }
+}
+
+TEST(Utils, QuaterniontoZYXMatchesReference)
+{
+  const Angles a(kSamples);
+  for (std::size_t i = 0; i < kSamples; ++i) {
+    const Eigen::Quaterniond q = referenceXYZtoQuaternion(a.roll[i], a.pitch[i], a.yaw[i]);
+    const Eigen::Vector3d expected = referenceQuaterniontoZYX(q.x(), q.y(), q.z(), q.w());
+    const Eigen::Vector3d actual = convertQuaterniontoZYX(q.x(), q.y(), q.z(), q.w());
+    EXPECT_LE((expected - actual).cwiseAbs().maxCoeff(), kTolerance) << i;
+  }
+}